@@ -1,9 +1,246 @@
 #include <malloc.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <RND_ErrMsg.h>
 #include <string.h>
 #include "RND_BitArray.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#define RND_BITARRAY_X86
+#include <immintrin.h>
+#endif
+
+// Emit the external definitions of the inline accessors
+extern inline bool RND_bitArrayGetUnchecked(const RND_BitArray *bitarray, size_t index);
+extern inline void RND_bitArraySetUnchecked(RND_BitArray *bitarray, size_t index, bool value);
+extern inline void RND_bitArrayToggleUnchecked(RND_BitArray *bitarray, size_t index);
+
+// The number of 64-bit words needed to store size bits
+static size_t RND_bitArrayWords(size_t size)
+{
+    return (size + 63) / 64;
+}
+
+// The mask of bits of the last word that belong to the bitarray
+static uint64_t RND_bitArrayTailMask(size_t size)
+{
+    return (size % 64)? ((uint64_t)1 << (size % 64)) - 1 : ~(uint64_t)0;
+}
+
+static void RND_bitArrayAssign(uint64_t *bits, size_t index, bool value)
+{
+    uint64_t mask = (uint64_t)1 << (index % 64);
+    bits[index / 64] = value? (bits[index / 64] | mask) : (bits[index / 64] & ~mask);
+}
+
+/* Return the 64 bits starting at bit 64*word+shift of an array of count
+ * words, where bits outside of the array are read as 0.
+ */
+static uint64_t RND_bitArrayLoad(const uint64_t *bits, size_t count, ptrdiff_t word, unsigned int shift)
+{
+    uint64_t lo = (word >= 0 && (size_t)word < count)? bits[word] : 0;
+    if (!shift) {
+        return lo;
+    }
+    uint64_t hi = (word + 1 >= 0 && (size_t)(word + 1) < count)? bits[word + 1] : 0;
+    return (lo >> shift) | (hi << (64 - shift));
+}
+
+/* A kernel combines count words of dest with count words of src,
+ * where the i-th source word is made of the upper bits of src[i]
+ * and the lower bits of src[i + 1] if shift is not 0.
+ */
+typedef void (*RND_BitArrayKernel)(uint64_t*, const uint64_t*, size_t, unsigned int);
+
+enum { RND_BITARRAY_AND, RND_BITARRAY_OR, RND_BITARRAY_XOR };
+
+#define RND_BITARRAY_SCALAR_KERNEL(name, op)                                              \
+static void name(uint64_t *dest, const uint64_t *src, size_t count, unsigned int shift)  \
+{                                                                                         \
+    if (shift) {                                                                          \
+        for (size_t i = 0; i < count; i++) {                                              \
+            dest[i] op (src[i] >> shift) | (src[i + 1] << (64 - shift));                  \
+        }                                                                                 \
+    } else {                                                                              \
+        for (size_t i = 0; i < count; i++) {                                              \
+            dest[i] op src[i];                                                            \
+        }                                                                                 \
+    }                                                                                     \
+}
+
+RND_BITARRAY_SCALAR_KERNEL(RND_bitArrayAndScalar, &=)
+RND_BITARRAY_SCALAR_KERNEL(RND_bitArrayOrScalar,  |=)
+RND_BITARRAY_SCALAR_KERNEL(RND_bitArrayXorScalar, ^=)
+
+static const RND_BitArrayKernel RND_bitArrayScalarKernels[] = {
+    RND_bitArrayAndScalar, RND_bitArrayOrScalar, RND_bitArrayXorScalar
+};
+
+#ifdef RND_BITARRAY_X86
+/* Vector kernels process 2 (SSE2) or 4 (AVX2) words per iteration
+ * with unaligned loads and leave the remaining words to the scalar one.
+ */
+#define RND_BITARRAY_SSE2_KERNEL(name, intrin, scalar)                                    \
+__attribute__((target("sse2")))                                                           \
+static void name(uint64_t *dest, const uint64_t *src, size_t count, unsigned int shift)  \
+{                                                                                         \
+    __m128i lo = _mm_cvtsi32_si128(shift), hi = _mm_cvtsi32_si128(64 - shift);            \
+    size_t i = 0;                                                                         \
+    for (; i + 2 <= count; i += 2) {                                                      \
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));                           \
+        if (shift) {                                                                      \
+            __m128i t = _mm_loadu_si128((const __m128i*)(src + i + 1));                   \
+            s = _mm_or_si128(_mm_srl_epi64(s, lo), _mm_sll_epi64(t, hi));                 \
+        }                                                                                 \
+        __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));                          \
+        _mm_storeu_si128((__m128i*)(dest + i), intrin(d, s));                             \
+    }                                                                                     \
+    scalar(dest + i, src + i, count - i, shift);                                          \
+}
+
+#define RND_BITARRAY_AVX2_KERNEL(name, intrin, scalar)                                    \
+__attribute__((target("avx2")))                                                           \
+static void name(uint64_t *dest, const uint64_t *src, size_t count, unsigned int shift)  \
+{                                                                                         \
+    __m128i lo = _mm_cvtsi32_si128(shift), hi = _mm_cvtsi32_si128(64 - shift);            \
+    size_t i = 0;                                                                         \
+    for (; i + 4 <= count; i += 4) {                                                      \
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));                        \
+        if (shift) {                                                                      \
+            __m256i t = _mm256_loadu_si256((const __m256i*)(src + i + 1));                \
+            s = _mm256_or_si256(_mm256_srl_epi64(s, lo), _mm256_sll_epi64(t, hi));        \
+        }                                                                                 \
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));                       \
+        _mm256_storeu_si256((__m256i*)(dest + i), intrin(d, s));                          \
+    }                                                                                     \
+    scalar(dest + i, src + i, count - i, shift);                                          \
+}
+
+RND_BITARRAY_SSE2_KERNEL(RND_bitArrayAndSSE2, _mm_and_si128, RND_bitArrayAndScalar)
+RND_BITARRAY_SSE2_KERNEL(RND_bitArrayOrSSE2,  _mm_or_si128,  RND_bitArrayOrScalar)
+RND_BITARRAY_SSE2_KERNEL(RND_bitArrayXorSSE2, _mm_xor_si128, RND_bitArrayXorScalar)
+RND_BITARRAY_AVX2_KERNEL(RND_bitArrayAndAVX2, _mm256_and_si256, RND_bitArrayAndScalar)
+RND_BITARRAY_AVX2_KERNEL(RND_bitArrayOrAVX2,  _mm256_or_si256,  RND_bitArrayOrScalar)
+RND_BITARRAY_AVX2_KERNEL(RND_bitArrayXorAVX2, _mm256_xor_si256, RND_bitArrayXorScalar)
+
+static const RND_BitArrayKernel RND_bitArraySSE2Kernels[] = {
+    RND_bitArrayAndSSE2, RND_bitArrayOrSSE2, RND_bitArrayXorSSE2
+};
+
+static const RND_BitArrayKernel RND_bitArrayAVX2Kernels[] = {
+    RND_bitArrayAndAVX2, RND_bitArrayOrAVX2, RND_bitArrayXorAVX2
+};
+#endif
+
+static size_t RND_bitArrayPopcountScalar(const uint64_t *bits, size_t count)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += __builtin_popcountll(bits[i]);
+    }
+    return total;
+}
+
+#ifdef RND_BITARRAY_X86
+// The same loop, but compiled to the popcnt instruction
+__attribute__((target("popcnt")))
+static size_t RND_bitArrayPopcountHW(const uint64_t *bits, size_t count)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += __builtin_popcountll(bits[i]);
+    }
+    return total;
+}
+#endif
+
+// Count the set bits in count words, using popcnt if the CPU supports it
+static size_t RND_bitArrayPopcount(const uint64_t *bits, size_t count)
+{
+    static size_t (*popcount)(const uint64_t*, size_t) = NULL;
+    if (!popcount) {
+#ifdef RND_BITARRAY_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("popcnt")) {
+            popcount = RND_bitArrayPopcountHW;
+        } else {
+            popcount = RND_bitArrayPopcountScalar;
+        }
+#else
+        popcount = RND_bitArrayPopcountScalar;
+#endif
+    }
+    return popcount(bits, count);
+}
+
+// Pick the widest kernels supported by the CPU on first use
+static const RND_BitArrayKernel *RND_bitArrayKernels()
+{
+    static const RND_BitArrayKernel *kernels = NULL;
+    if (!kernels) {
+#ifdef RND_BITARRAY_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernels = RND_bitArrayAVX2Kernels;
+        } else if (__builtin_cpu_supports("sse2")) {
+            kernels = RND_bitArraySSE2Kernels;
+        } else {
+            kernels = RND_bitArrayScalarKernels;
+        }
+#else
+        kernels = RND_bitArrayScalarKernels;
+#endif
+    }
+    return kernels;
+}
+
+static void RND_bitArrayCombine(uint64_t *dest, uint64_t src, int op)
+{
+    switch (op) {
+        case RND_BITARRAY_AND: *dest &= src; break;
+        case RND_BITARRAY_OR:  *dest |= src; break;
+        case RND_BITARRAY_XOR: *dest ^= src; break;
+    }
+}
+
+/* Combine dest with src aligned to the right, i.e. bit i of dest
+ * with bit (i + src->size - dest->size) of src. Word k of dest thus
+ * lines up with bits starting at 64*k + delta of src. The words for
+ * which both overlapping source words exist go through a kernel, the
+ * few on the edges are assembled one by one with missing bits read as 0.
+ */
+static void RND_bitArrayApply(RND_BitArray *dest, const RND_BitArray *src, int op)
+{
+    ptrdiff_t dwords = RND_bitArrayWords(dest->size),
+              swords = RND_bitArrayWords(src->size);
+    ptrdiff_t delta  = (ptrdiff_t)src->size - (ptrdiff_t)dest->size;
+    ptrdiff_t qd = (delta >= 0)? delta / 64 : -((63 - delta) / 64);
+    unsigned int shift = delta - qd * 64;
+    ptrdiff_t lo = (-qd > 0)? -qd : 0,
+              hi = swords - qd - (shift != 0);
+    if (lo > dwords) {
+        lo = dwords;
+    }
+    if (hi > dwords) {
+        hi = dwords;
+    }
+    if (hi < lo) {
+        hi = lo;
+    }
+    for (ptrdiff_t k = 0; k < lo; k++) {
+        RND_bitArrayCombine(dest->bits + k, RND_bitArrayLoad(src->bits, swords, k + qd, shift), op);
+    }
+    if (hi > lo) {
+        RND_bitArrayKernels()[op](dest->bits + lo, src->bits + lo + qd, hi - lo, shift);
+    }
+    for (ptrdiff_t k = hi; k < dwords; k++) {
+        RND_bitArrayCombine(dest->bits + k, RND_bitArrayLoad(src->bits, swords, k + qd, shift), op);
+    }
+    if (dwords) {
+        dest->bits[dwords - 1] &= RND_bitArrayTailMask(dest->size);
+    }
+}
+
 RND_BitArray *RND_bitArrayCreate(size_t size)
 {
     RND_BitArray *bitarray;
@@ -12,15 +249,59 @@ RND_BitArray *RND_bitArrayCreate(size_t size)
         return NULL;
     }
     bitarray->size = size;
-    size = (size + 7) / 8;
-    if (!(bitarray->bits = (uint8_t*)calloc(size, sizeof(uint8_t)))) {
+    size = RND_bitArrayWords(size);
+    if (!(bitarray->bits = (uint64_t*)calloc(size, sizeof(uint64_t)))) {
         RND_ERROR("calloc");
         free(bitarray);
         return NULL;
     }
+    bitarray->capacity = size;
     return bitarray;
 }
 
+int RND_bitArrayResize(RND_BitArray *bitarray, size_t size)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 1;
+    }
+    size_t words = RND_bitArrayWords(size),
+           old   = RND_bitArrayWords(bitarray->size);
+    if (words > bitarray->capacity) {
+        size_t capacity = (words > 2 * bitarray->capacity)? words : 2 * bitarray->capacity;
+        uint64_t *bits;
+        if (!(bits = (uint64_t*)realloc(bitarray->bits, capacity * sizeof(uint64_t)))) {
+            RND_ERROR("realloc");
+            return 2;
+        }
+        memset(bits + bitarray->capacity, 0, (capacity - bitarray->capacity) * sizeof(uint64_t));
+        bitarray->bits     = bits;
+        bitarray->capacity = capacity;
+    } else if (size < bitarray->size) {
+        // Keep everything past the end cleared, so that growing again yields 0s
+        memset(bitarray->bits + words, 0, (old - words) * sizeof(uint64_t));
+        if (words) {
+            bitarray->bits[words - 1] &= RND_bitArrayTailMask(size);
+        }
+    }
+    bitarray->size = size;
+    return 0;
+}
+
+int RND_bitArrayPushBack(RND_BitArray *bitarray, bool value)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_bitArrayResize(bitarray, bitarray->size + 1))) {
+        return error;
+    }
+    RND_bitArrayAssign(bitarray->bits, bitarray->size - 1, value);
+    return 0;
+}
+
 bool RND_bitArrayGet(const RND_BitArray *bitarray, size_t index)
 {
     if (!bitarray) {
@@ -31,7 +312,7 @@ bool RND_bitArrayGet(const RND_BitArray *bitarray, size_t index)
         RND_ERROR("index %lu out of bounds", index);
         return 0;
     }
-    return bitarray->bits[index / 8] & (0x80 >> (index % 8));
+    return (bitarray->bits[index / 64] >> (index % 64)) & 1;
 }
 
 int RND_bitArraySet(RND_BitArray *bitarray, size_t index, bool value)
@@ -44,11 +325,34 @@ int RND_bitArraySet(RND_BitArray *bitarray, size_t index, bool value)
         RND_ERROR("index %lu out of bounds", index);
         return 1;
     }
-    uint8_t *field = bitarray->bits + (index / 8);
-    *field = value? (*field | (0x80 >> (index % 8))) : (*field & ~(0x80 >> (index % 8)));
+    RND_bitArrayAssign(bitarray->bits, index, value);
     return 0;
 }
 
+/* Digits are stored in the bitarray with their most significant bit at
+ * the lowest index, so a digit is converted to and from the bits it
+ * covers, read from the lowest index up, by reversing its bits. These
+ * tables map a character to 1 + its digit value (0 for non-digits),
+ * and the reversed bits of a digit to its character for each base.
+ */
+static const uint8_t RND_bitArrayDigitValues[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8,
+    ['8'] = 9, ['9'] = 10, ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+static const uint8_t RND_bitArrayReversedNibbles[16] = {
+    0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15
+};
+static const char *const RND_bitArrayDigitChars[] = {
+    [2] = "01", [8] = "04261537", [16] = "084c2a6e195d3b7f"
+};
+
+// The number of bits per digit of a base, or 0 if the base is not supported
+static unsigned int RND_bitArrayDigitBits(int base)
+{
+    return (base == 2)? 1 : (base == 8)? 3 : (base == 16)? 4 : 0;
+}
+
 int RND_bitArraySetf(RND_BitArray *bitarray, const char *format)
 {
     if (!bitarray) {
@@ -82,66 +386,91 @@ int RND_bitArraySetf(RND_BitArray *bitarray, const char *format)
         RND_ERROR("invalid format string");
         return 2;
     }
-    const char *p = format + strlen(format) - 1;
-    i = bitarray->size - 1;
-    while (p != c && i > 0) {
-        uint8_t *field, val;
-        switch (base) {
-            case 2:
-                if ('0' <= *p && *p < '2') {
-                    val = (*p - '0');
-                    field = bitarray->bits + (i / 8);
-                    *field = val? (*field | (0x80 >> (i % 8))) : (*field & ~(0x80 >> (i % 8)));
-                    i--;
-                } else if (*p != ' ' && *p != '\t') {
-                    base = 0;
-                }
-                break;
-            case 8:
-                if ('0' <= *p && *p < '8') {
-                    val = (*p - '0');
-                    for (int j = 2; j >= 0; j--) {
-                        field = bitarray->bits + (i / 8);
-                        *field = (val & (04 >> j))? (*field | (0x80 >> (i % 8))) : (*field & ~(0x80 >> (i % 8)));
-                        i--;
-                    }
-                } else if (*p != ' ' && *p != '\t') {
-                    base = 0;
-                }
-                break;
-            case 16:
-                if (('0' <= *p && *p <= '9') || ('a' <= *p && *p <= 'f') || ('A' <= *p && *p <= 'F')) {
-                    if ('0' <= *p && *p <= '9') {
-                        val = (*p - '0');
-                    } else if ('a' <= *p && *p <= 'f') {
-                        val = (*p - 'a' + 10);
-                    } else if ('A' <= *p && *p <= 'F') {
-                        val = (*p - 'A' + 10);
-                    }
-                    for (int j = 3; j >= 0; j--) {
-                        field = bitarray->bits + (i / 8);
-                        *field = (val & (0x8 >> j))? (*field | (0x80 >> (i % 8))) : (*field & ~(0x80 >> (i % 8)));
-                        i--;
-                    }
-                } else if (*p != ' ' && *p != '\t') {
-                    base = 0;
-                }
-                break;
+
+    // Validate and count the digits before touching the bitarray
+    unsigned int digit_bits = RND_bitArrayDigitBits(base);
+    size_t digits = 0;
+    for (const unsigned char *p = (const unsigned char*)c + 1; *p; p++) {
+        if (*p == ' ' || *p == '\t') {
+            continue;
         }
-        if (base == 0) {
+        if (!RND_bitArrayDigitValues[*p] || RND_bitArrayDigitValues[*p] > base) {
             RND_ERROR("invalid format string");
             return 2;
         }
-        p--;
+        digits++;
+    }
+
+    /* The last digit ends at the last bit, so the first one starts at
+     * a negative position if there are more digits than fit. Each word
+     * is assembled in acc and written out whole.
+     */
+    memset(bitarray->bits, 0, sizeof *bitarray->bits * RND_bitArrayWords(bitarray->size));
+    ptrdiff_t pos = (ptrdiff_t)bitarray->size - (ptrdiff_t)(digits * digit_bits);
+    size_t word = (pos > 0)? pos / 64 : 0;
+    uint64_t acc = 0;
+    for (const unsigned char *p = (const unsigned char*)c + 1; *p; p++) {
+        if (*p == ' ' || *p == '\t') {
+            continue;
+        }
+        uint64_t val = RND_bitArrayReversedNibbles[RND_bitArrayDigitValues[*p] - 1] >> (4 - digit_bits);
+        unsigned int count = digit_bits;
+        if (pos < 0) {
+            if (pos + (ptrdiff_t)count <= 0) {
+                pos += count;
+                continue;
+            }
+            val >>= -pos;
+            count += pos;
+            pos = 0;
+        }
+        unsigned int shift = pos % 64;
+        acc |= val << shift;
+        if (shift + count >= 64) {
+            bitarray->bits[word++] = acc;
+            acc = (shift + count > 64)? val >> (64 - shift) : 0;
+        }
+        pos += count;
     }
-    while (i > 0) {
-        uint8_t *field = bitarray->bits + (i / 8);
-        *field &= ~(0x80 >> (i % 8));
-        i--;
+    if (pos % 64) {
+        bitarray->bits[word] = acc;
     }
     return 0;
 }
 
+/* Write digits [first, first + length) of the representation of a
+ * bitarray in digits of digit_bits bits, which starts with enough
+ * leading 0 bits to make the bitarray a whole number of digits.
+ */
+static void RND_bitArrayFormatDigits(const RND_BitArray *bitarray, char *out, size_t first, size_t length, unsigned int digit_bits)
+{
+    const char *chars = RND_bitArrayDigitChars[1 << digit_bits];
+    size_t total = (bitarray->size + digit_bits - 1) / digit_bits,
+           count = RND_bitArrayWords(bitarray->size);
+    unsigned int per_word = 64 / digit_bits;
+    uint64_t mask = ((uint64_t)1 << digit_bits) - 1;
+    ptrdiff_t pos = (ptrdiff_t)bitarray->size - (ptrdiff_t)((total - first) * digit_bits);
+    while (length) {
+        // Floor division, as pos is negative for the leading digit
+        ptrdiff_t word = (pos >= 0)? pos / 64 : -1;
+        uint64_t bits = RND_bitArrayLoad(bitarray->bits, count, word, pos - word * 64);
+        unsigned int n = (length < per_word)? length : per_word;
+        for (unsigned int i = 0; i < n; i++, bits >>= digit_bits) {
+            *out++ = chars[bits & mask];
+        }
+        pos += n * digit_bits;
+        length -= n;
+    }
+}
+
+// Write the prefix recognized by RND_bitArraySetf for a base and return its length
+static size_t RND_bitArrayFormatPrefix(char *out, int base)
+{
+    out[0] = '0';
+    out[1] = (base == 16)? 'x' : 'b';
+    return (base == 8)? 1 : 2;
+}
+
 int RND_bitArrayToggle(RND_BitArray *bitarray, size_t index)
 {
     if (!bitarray) {
@@ -152,9 +481,7 @@ int RND_bitArrayToggle(RND_BitArray *bitarray, size_t index)
         RND_ERROR("index %lu out of bounds", index);
         return 1;
     }
-    bool newval = !(bitarray->bits[index / 8] & (0x80 >> (index % 8)));
-    uint8_t *field = bitarray->bits + (index / 8);
-    *field = newval? (*field | (0x80 >> (index % 8))) : (*field & ~(0x80 >> (index % 8)));
+    bitarray->bits[index / 64] ^= (uint64_t)1 << (index % 64);
     return 0;
 }
 
@@ -178,25 +505,97 @@ size_t RND_bitArraySize(const RND_BitArray *bitarray)
     return bitarray->size;
 }
 
+size_t RND_bitArrayFormat(const RND_BitArray *bitarray, char *buffer, size_t length, int base)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 0;
+    }
+    unsigned int digit_bits = RND_bitArrayDigitBits(base);
+    if (!digit_bits) {
+        RND_ERROR("base %d not supported", base);
+        return 0;
+    }
+    char prefix[2];
+    size_t prefix_length = RND_bitArrayFormatPrefix(prefix, base),
+           digits = (bitarray->size + digit_bits - 1) / digit_bits;
+    // An octal number needs at least one digit after the leading 0
+    if (base == 8 && digits == 0) {
+        prefix[prefix_length++] = '0';
+    }
+    size_t total = prefix_length + digits;
+    if (!buffer || !length) {
+        return total;
+    }
+    size_t n = (prefix_length < length - 1)? prefix_length : length - 1;
+    memcpy(buffer, prefix, n);
+    if (total > n) {
+        size_t m = ((total < length - 1)? total : length - 1) - n;
+        RND_bitArrayFormatDigits(bitarray, buffer + n, 0, m, digit_bits);
+        n += m;
+    }
+    buffer[n] = '\0';
+    return total;
+}
+
+int RND_bitArrayWrite(const RND_BitArray *bitarray, FILE *stream, int base)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 1;
+    }
+    if (!stream) {
+        RND_ERROR("the stream does not exist");
+        return 1;
+    }
+    unsigned int digit_bits = RND_bitArrayDigitBits(base);
+    if (!digit_bits) {
+        RND_ERROR("base %d not supported", base);
+        return 2;
+    }
+    char buffer[4096];
+    size_t n = RND_bitArrayFormatPrefix(buffer, base),
+           digits = (bitarray->size + digit_bits - 1) / digit_bits;
+    if (base == 8 && digits == 0) {
+        buffer[n++] = '0';
+    }
+    for (size_t first = 0; first < digits || n; ) {
+        size_t m = sizeof buffer - n;
+        if (m > digits - first) {
+            m = digits - first;
+        }
+        RND_bitArrayFormatDigits(bitarray, buffer + n, first, m, digit_bits);
+        first += m;
+        n += m;
+        if (fwrite(buffer, 1, n, stream) != n) {
+            RND_ERROR("failed to write to the stream");
+            return 3;
+        }
+        n = 0;
+    }
+    return 0;
+}
+
 int RND_bitArrayPrint(const RND_BitArray *bitarray)
 {
     if (!bitarray) {
         RND_ERROR("the bitarray does not exist");
         return 1;
     }
-    int linecount = 0;
-    int bitcount  = bitarray->size;
-    for (size_t i = 0; i < (bitarray->size + 7) / 8; i++) {
-        int jmax = (bitcount > 8)? 8 : bitcount;
-        for (int j = 0; j < jmax; j++, bitcount--) {
-            printf("%d", !!(bitarray->bits[i] & (0x80 >> j)));
+    // Each line of 32 bits is assembled in full before printing
+    char line[32 + 4 + 2];
+    size_t n = 0;
+    for (size_t i = 0; i < bitarray->size; i++) {
+        line[n++] = '0' + ((bitarray->bits[i / 64] >> (i % 64)) & 1);
+        if (i % 8 == 7 || i == bitarray->size - 1) {
+            line[n++] = ' ';
+        }
+        if (i % 32 == 31 || i == bitarray->size - 1) {
+            line[n++] = '\n';
+            fwrite(line, 1, n, stdout);
+            n = 0;
         }
-        printf(" ");
-        if (++linecount % 4 == 0)
-            putc('\n', stdout);
     }
-    if (bitarray->size % 32)
-        putc('\n', stdout);
 
     return 0;
 }
@@ -210,33 +609,7 @@ int RND_bitArrayAnd(RND_BitArray *dest, const RND_BitArray *src)
     if (!src) {
         return 0;
     }
-    size_t i = dest->size,
-           j = src->size;
-    bool jstop = false;
-    if (i % 8 == 0 && j % 8 == 0) {
-        i = (i + 7) / 8, j = (j + 7) / 8;
-        while (i-- > 0) {
-            if (!jstop && j-- > 0) {
-                dest->bits[i] &= src->bits[j];
-            } else {
-                jstop = true;
-                dest->bits[i] = 0x00;
-            }
-        }
-    } else {
-        while (i-- > 0) {
-            uint8_t *field = dest->bits + (i / 8);
-            bool val1 = (*field & (0x80 >> (i % 8)));
-            if (!jstop && j-- > 0 && val1) {
-                bool val2 = (src->bits[j / 8] & (0x80 >> (j % 8)));
-                *field = (val1 && val2)? *field : (*field & ~(0x80 >> (i % 8)));
-            } else {
-                jstop = true;
-                *field &= ~(0x80 >> (i % 8));
-            }
-        }
-    }
-    
+    RND_bitArrayApply(dest, src, RND_BITARRAY_AND);
     return 0;
 }
 
@@ -249,22 +622,7 @@ int RND_bitArrayOr(RND_BitArray *dest, const RND_BitArray *src)
     if (!src) {
         return 0;
     }
-    size_t i = dest->size,
-           j = src->size;
-    if (i % 8 == 0 && j % 8 == 0) {
-        i = (i + 7) / 8, j = (j + 7) / 8;
-        while (i-- > 0 && j-- > 0) {
-            dest->bits[i] |= src->bits[j];
-        }
-    } else {
-        while (i-- > 0 && j-- > 0) {
-            uint8_t *field = dest->bits + (i / 8);
-            bool val1 = (*field & (0x80 >> (i % 8))),
-                 val2 = (src->bits[j / 8] & (0x80 >> (j % 8)));
-            *field = (val1 || val2)? (*field | (0x80 >> (i % 8))) : *field;
-        }
-    }
-    
+    RND_bitArrayApply(dest, src, RND_BITARRAY_OR);
     return 0;
 }
 
@@ -277,22 +635,7 @@ int RND_bitArrayXor(RND_BitArray *dest, const RND_BitArray *src)
     if (!src) {
         return 0;
     }
-    size_t i = dest->size,
-           j = src->size;
-    if (i % 8 == 0 && j % 8 == 0) {
-        i = (i + 7) / 8, j = (j + 7) / 8;
-        while (i-- > 0 && j-- > 0) {
-            dest->bits[i] ^= src->bits[j];
-        }
-    } else {
-        while (i-- > 0 && j-- > 0) {
-            uint8_t *field = dest->bits + (i / 8);
-            bool val1 = (*field & (0x80 >> (i % 8))),
-                 val2 = (src->bits[j / 8] & (0x80 >> (j % 8)));
-            *field = ((val1 && !val2) || (!val1 && val2))? (*field | (0x80 >> (i % 8))) : (*field & ~(0x80 >> (i % 8)));
-        }
-    }
-    
+    RND_bitArrayApply(dest, src, RND_BITARRAY_XOR);
     return 0;
 }
 
@@ -302,9 +645,223 @@ int RND_bitArrayNegate(RND_BitArray *bitarray)
         RND_ERROR("the bitarray does not exist");
         return 1;
     }
-    for (size_t i = 0; i < (bitarray->size + 7) / 8; i++) {
+    size_t words = RND_bitArrayWords(bitarray->size);
+    for (size_t i = 0; i < words; i++) {
         bitarray->bits[i] = ~bitarray->bits[i];
     }
+    if (words) {
+        bitarray->bits[words - 1] &= RND_bitArrayTailMask(bitarray->size);
+    }
+    return 0;
+}
+
+// The number of words of every operand evaluated at a time by RND_bitArrayEval
+#define RND_BITARRAY_EVAL_CHUNK 128
+
+/* RND_bitArrayEval first compiles the expression into postfix notation,
+ * where letters push an operand and ~, &, ^, | pop their arguments and
+ * push the result, so that evaluating it needs neither the parser nor
+ * recursion. Every character yields at most one instruction.
+ */
+typedef struct RND_BitArrayParser
+{
+    const char *c;
+    char *program;
+    size_t length;
+    size_t operand_count;
+    int depth, nesting;
+} RND_BitArrayParser;
+
+static void RND_bitArraySkipSpaces(RND_BitArrayParser *parser)
+{
+    while (*parser->c == ' ' || *parser->c == '\t') {
+        parser->c++;
+    }
+}
+
+static bool RND_bitArrayParseBinary(RND_BitArrayParser *parser, int level);
+
+// Parse any number of ~ followed by a letter or an expression in parentheses
+static bool RND_bitArrayParseUnary(RND_BitArrayParser *parser)
+{
+    bool negate = false;
+    RND_bitArraySkipSpaces(parser);
+    while (*parser->c == '~') {
+        negate = !negate;
+        parser->c++;
+        RND_bitArraySkipSpaces(parser);
+    }
+    char c = *parser->c;
+    if (c == '(') {
+        if (++parser->nesting > RND_BITARRAY_EVAL_DEPTH) {
+            return false;
+        }
+        parser->c++;
+        if (!RND_bitArrayParseBinary(parser, 0)) {
+            return false;
+        }
+        RND_bitArraySkipSpaces(parser);
+        if (*parser->c != ')') {
+            return false;
+        }
+        parser->c++;
+        parser->nesting--;
+    } else if (c >= 'a' && c <= 'z' && (size_t)(c - 'a') < parser->operand_count) {
+        if (++parser->depth > RND_BITARRAY_EVAL_DEPTH) {
+            return false;
+        }
+        parser->program[parser->length++] = c;
+        parser->c++;
+    } else {
+        return false;
+    }
+    if (negate) {
+        parser->program[parser->length++] = '~';
+    }
+    return true;
+}
+
+// Parse operands of the operator of a given level joined by that operator
+static bool RND_bitArrayParseBinary(RND_BitArrayParser *parser, int level)
+{
+    static const char operators[] = "|^&";
+    if (level == 3) {
+        return RND_bitArrayParseUnary(parser);
+    }
+    if (!RND_bitArrayParseBinary(parser, level + 1)) {
+        return false;
+    }
+    for (;;) {
+        RND_bitArraySkipSpaces(parser);
+        if (*parser->c != operators[level]) {
+            return true;
+        }
+        parser->c++;
+        if (!RND_bitArrayParseBinary(parser, level + 1)) {
+            return false;
+        }
+        parser->program[parser->length++] = operators[level];
+        parser->depth--;
+    }
+}
+
+/* Return a pointer to count words of src lined up with word first of
+ * the result, which points straight into src if the words are aligned,
+ * and otherwise to buffer, where they are assembled.
+ */
+static const uint64_t *RND_bitArrayEvalLoad(const RND_BitArray *src, ptrdiff_t qd, unsigned int shift, size_t first, size_t count, uint64_t *buffer)
+{
+    size_t swords = RND_bitArrayWords(src->size);
+    ptrdiff_t word = (ptrdiff_t)first + qd;
+    if (!shift && word >= 0 && (size_t)word + count <= swords) {
+        return src->bits + word;
+    }
+    for (size_t i = 0; i < count; i++) {
+        buffer[i] = RND_bitArrayLoad(src->bits, swords, word + i, shift);
+    }
+    return buffer;
+}
+
+// Move an intermediate result into its scratch buffer, so that it can be overwritten
+static uint64_t *RND_bitArrayEvalScratch(const uint64_t **stack, uint64_t (*scratch)[RND_BITARRAY_EVAL_CHUNK], int top, size_t count)
+{
+    if (stack[top] != scratch[top]) {
+        memcpy(scratch[top], stack[top], sizeof(uint64_t) * count);
+        stack[top] = scratch[top];
+    }
+    return scratch[top];
+}
+
+int RND_bitArrayEval(RND_BitArray *dest, size_t *count, const char *expression, const RND_BitArray *const *operands, size_t operand_count)
+{
+    if (!dest && !count) {
+        RND_ERROR("the result has nowhere to go");
+        return 1;
+    }
+    if (!expression) {
+        RND_ERROR("the expression does not exist");
+        return 1;
+    }
+    if (!operands) {
+        RND_ERROR("the operands do not exist");
+        return 1;
+    }
+    if (operand_count > 26) {
+        operand_count = 26;
+    }
+    if (!dest && (!operand_count || !operands[0])) {
+        RND_ERROR("the first operand does not exist");
+        return 1;
+    }
+
+    RND_BitArrayParser parser = { expression, NULL, 0, operand_count, 0, 0 };
+    if (!(parser.program = (char*)malloc(strlen(expression) + 1))) {
+        RND_ERROR("malloc");
+        return 3;
+    }
+    bool valid = RND_bitArrayParseBinary(&parser, 0);
+    RND_bitArraySkipSpaces(&parser);
+    if (!valid || *parser.c != '\0') {
+        RND_ERROR("invalid expression at \"%s\"", parser.c);
+        free(parser.program);
+        return 2;
+    }
+    parser.program[parser.length] = '\0';
+
+    // Line up each operand with the result like RND_bitArrayApply does
+    size_t size = dest? dest->size : operands[0]->size;
+    ptrdiff_t qds[26];
+    unsigned int shifts[26];
+    for (const char *op = parser.program; *op; op++) {
+        if (*op < 'a' || *op > 'z') {
+            continue;
+        }
+        const RND_BitArray *src = operands[*op - 'a'];
+        if (!src) {
+            RND_ERROR("operand %c does not exist", *op);
+            free(parser.program);
+            return 1;
+        }
+        ptrdiff_t delta = (ptrdiff_t)src->size - (ptrdiff_t)size;
+        qds[*op - 'a'] = (delta >= 0)? delta / 64 : -((63 - delta) / 64);
+        shifts[*op - 'a'] = delta - qds[*op - 'a'] * 64;
+    }
+
+    const RND_BitArrayKernel *kernels = RND_bitArrayKernels();
+    uint64_t scratch[RND_BITARRAY_EVAL_DEPTH][RND_BITARRAY_EVAL_CHUNK], ones[RND_BITARRAY_EVAL_CHUNK];
+    const uint64_t *stack[RND_BITARRAY_EVAL_DEPTH];
+    memset(ones, 0xff, sizeof ones);
+    size_t words = RND_bitArrayWords(size), total = 0;
+    for (size_t first = 0; first < words; first += RND_BITARRAY_EVAL_CHUNK) {
+        size_t n = (words - first < RND_BITARRAY_EVAL_CHUNK)? words - first : RND_BITARRAY_EVAL_CHUNK;
+        int top = -1;
+        for (const char *op = parser.program; *op; op++) {
+            if (*op >= 'a' && *op <= 'z') {
+                top++;
+                stack[top] = RND_bitArrayEvalLoad(operands[*op - 'a'], qds[*op - 'a'], shifts[*op - 'a'], first, n, scratch[top]);
+            } else if (*op == '~') {
+                kernels[RND_BITARRAY_XOR](RND_bitArrayEvalScratch(stack, scratch, top, n), ones, n, 0);
+            } else {
+                top--;
+                int kernel = (*op == '&')? RND_BITARRAY_AND : (*op == '|')? RND_BITARRAY_OR : RND_BITARRAY_XOR;
+                kernels[kernel](RND_bitArrayEvalScratch(stack, scratch, top, n), stack[top + 1], n, 0);
+            }
+        }
+        // Negation sets the bits past the end, which must stay 0
+        if (first + n == words) {
+            RND_bitArrayEvalScratch(stack, scratch, 0, n)[n - 1] &= RND_bitArrayTailMask(size);
+        }
+        if (dest && stack[0] != dest->bits + first) {
+            memcpy(dest->bits + first, stack[0], sizeof(uint64_t) * n);
+        }
+        if (count) {
+            total += RND_bitArrayPopcount(stack[0], n);
+        }
+    }
+    if (count) {
+        *count = total;
+    }
+    free(parser.program);
     return 0;
 }
 
@@ -320,8 +877,368 @@ RND_BitArray *RND_bitArrayCopy(const RND_BitArray *bitarray)
         RND_ERROR("RND_bitArrayCreate returned NULL");
         return NULL;
     }
-    for (size_t i = 0; i < (bitarray->size + 7) / 8; i++) {
-        new->bits[i] = bitarray->bits[i];
-    }
+    memcpy(new->bits, bitarray->bits, RND_bitArrayWords(bitarray->size) * sizeof(uint64_t));
     return new;
 }
+
+/* Return the index of the first bit with a given value at or after
+ * start, or the size of the bitarray if there is none.
+ */
+static size_t RND_bitArrayScan(const RND_BitArray *bitarray, size_t start, bool value)
+{
+    if (start >= bitarray->size) {
+        return bitarray->size;
+    }
+    size_t words = RND_bitArrayWords(bitarray->size),
+           word  = start / 64;
+    uint64_t flip = value? 0 : ~(uint64_t)0,
+             bits = (bitarray->bits[word] ^ flip) & (~(uint64_t)0 << (start % 64));
+    while (!bits) {
+        if (++word == words) {
+            return bitarray->size;
+        }
+        bits = bitarray->bits[word] ^ flip;
+    }
+    size_t index = word * 64 + __builtin_ctzll(bits);
+    return (index < bitarray->size)? index : bitarray->size;
+}
+
+size_t RND_bitArrayFindFirst(const RND_BitArray *bitarray, bool value)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 0;
+    }
+    return RND_bitArrayScan(bitarray, 0, value);
+}
+
+size_t RND_bitArrayFindNext(const RND_BitArray *bitarray, size_t index, bool value)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 0;
+    }
+    if (index >= bitarray->size) {
+        return bitarray->size;
+    }
+    return RND_bitArrayScan(bitarray, index + 1, value);
+}
+
+int RND_bitArrayMap(const RND_BitArray *bitarray, int (*map)(size_t, void*), void *arg)
+{
+    if (!bitarray || !map) {
+        RND_WARN("bitarray or map function empty");
+        return 1;
+    }
+    size_t words = RND_bitArrayWords(bitarray->size);
+    for (size_t word = 0; word < words; word++) {
+        for (uint64_t bits = bitarray->bits[word]; bits; bits &= bits - 1) {
+            size_t index = word * 64 + __builtin_ctzll(bits);
+            int error;
+            if ((error = map(index, arg))) {
+                RND_ERROR("map function returned %d for bit %lu", error, index);
+                return 2;
+            }
+        }
+    }
+    return 0;
+}
+
+// The mask of the n lowest bits of a word
+static uint64_t RND_bitArrayLowMask(size_t n)
+{
+    return (n < 64)? ((uint64_t)1 << n) - 1 : ~(uint64_t)0;
+}
+
+static bool RND_bitArrayRangeCheck(const RND_BitArray *bitarray, size_t start, size_t length)
+{
+    if (start > bitarray->size || length > bitarray->size - start) {
+        RND_ERROR("range %lu+%lu out of bounds", start, length);
+        return false;
+    }
+    return true;
+}
+
+enum { RND_BITARRAY_SET, RND_BITARRAY_CLEAR, RND_BITARRAY_FLIP };
+
+// Apply op to the bits of a word selected by mask
+static void RND_bitArrayFillWord(uint64_t *word, uint64_t mask, int op)
+{
+    switch (op) {
+        case RND_BITARRAY_SET:   *word |= mask;  break;
+        case RND_BITARRAY_CLEAR: *word &= ~mask; break;
+        case RND_BITARRAY_FLIP:  *word ^= mask;  break;
+    }
+}
+
+/* Apply op to a range of bits: masks for the partial words
+ * on both ends, whole words in between.
+ */
+static void RND_bitArrayFill(RND_BitArray *bitarray, size_t start, size_t length, int op)
+{
+    if (!length) {
+        return;
+    }
+    size_t first = start / 64, last = (start + length - 1) / 64;
+    uint64_t head = ~(uint64_t)0 << (start % 64),
+             tail = RND_bitArrayLowMask((start + length - 1) % 64 + 1);
+    if (first == last) {
+        RND_bitArrayFillWord(bitarray->bits + first, head & tail, op);
+        return;
+    }
+    RND_bitArrayFillWord(bitarray->bits + first, head, op);
+    if (op == RND_BITARRAY_FLIP) {
+        for (size_t i = first + 1; i < last; i++) {
+            bitarray->bits[i] = ~bitarray->bits[i];
+        }
+    } else {
+        memset(bitarray->bits + first + 1, (op == RND_BITARRAY_SET)? 0xff : 0x00, (last - first - 1) * sizeof(uint64_t));
+    }
+    RND_bitArrayFillWord(bitarray->bits + last, tail, op);
+}
+
+int RND_bitArraySetRange(RND_BitArray *bitarray, size_t start, size_t length)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 1;
+    }
+    if (!RND_bitArrayRangeCheck(bitarray, start, length)) {
+        return 2;
+    }
+    RND_bitArrayFill(bitarray, start, length, RND_BITARRAY_SET);
+    return 0;
+}
+
+int RND_bitArrayClearRange(RND_BitArray *bitarray, size_t start, size_t length)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 1;
+    }
+    if (!RND_bitArrayRangeCheck(bitarray, start, length)) {
+        return 2;
+    }
+    RND_bitArrayFill(bitarray, start, length, RND_BITARRAY_CLEAR);
+    return 0;
+}
+
+int RND_bitArrayFlipRange(RND_BitArray *bitarray, size_t start, size_t length)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 1;
+    }
+    if (!RND_bitArrayRangeCheck(bitarray, start, length)) {
+        return 2;
+    }
+    RND_bitArrayFill(bitarray, start, length, RND_BITARRAY_FLIP);
+    return 0;
+}
+
+/* Copy the bits of src starting at src_start to dest[lo, hi),
+ * which must not cross a word boundary of dest.
+ */
+static void RND_bitArrayCopyChunk(RND_BitArray *dest, size_t lo, size_t hi, const RND_BitArray *src, size_t src_start)
+{
+    uint64_t mask  = RND_bitArrayLowMask(hi - lo),
+             value = RND_bitArrayLoad(src->bits, RND_bitArrayWords(src->size), src_start / 64, src_start % 64) & mask;
+    uint64_t *word = dest->bits + lo / 64;
+    *word = (*word & ~(mask << (lo % 64))) | (value << (lo % 64));
+}
+
+int RND_bitArrayCopyRange(RND_BitArray *dest, size_t dest_start, const RND_BitArray *src, size_t src_start, size_t length)
+{
+    if (!dest || !src) {
+        RND_ERROR("the destination or source bitarray does not exist");
+        return 1;
+    }
+    if (!RND_bitArrayRangeCheck(dest, dest_start, length) || !RND_bitArrayRangeCheck(src, src_start, length)) {
+        return 2;
+    }
+    size_t end = dest_start + length;
+    // Go backwards if the source range could be overwritten before it is read
+    if (dest == src && dest_start > src_start) {
+        for (size_t hi = end; hi > dest_start;) {
+            size_t lo = (hi - 1) / 64 * 64;
+            if (lo < dest_start) {
+                lo = dest_start;
+            }
+            RND_bitArrayCopyChunk(dest, lo, hi, src, src_start + (lo - dest_start));
+            hi = lo;
+        }
+    } else {
+        for (size_t lo = dest_start; lo < end;) {
+            size_t hi = (lo / 64 + 1) * 64;
+            if (hi > end) {
+                hi = end;
+            }
+            RND_bitArrayCopyChunk(dest, lo, hi, src, src_start + (lo - dest_start));
+            lo = hi;
+        }
+    }
+    return 0;
+}
+
+size_t RND_bitArrayCount(const RND_BitArray *bitarray)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return 0;
+    }
+    return RND_bitArrayPopcount(bitarray->bits, RND_bitArrayWords(bitarray->size));
+}
+
+RND_BitArrayIndex *RND_bitArrayIndexCreate(const RND_BitArray *bitarray)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return NULL;
+    }
+    RND_BitArrayIndex *index;
+    if (!(index = (RND_BitArrayIndex*)malloc(sizeof(RND_BitArrayIndex)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    index->bitarray = bitarray;
+    index->supers   = NULL;
+    index->blocks   = NULL;
+    index->samples  = NULL;
+    if (RND_bitArrayIndexUpdate(index)) {
+        RND_ERROR("RND_bitArrayIndexUpdate failed");
+        RND_bitArrayIndexDestroy(index);
+        return NULL;
+    }
+    return index;
+}
+
+int RND_bitArrayIndexUpdate(RND_BitArrayIndex *index)
+{
+    if (!index) {
+        RND_ERROR("the index does not exist");
+        return 1;
+    }
+    const RND_BitArray *bitarray = index->bitarray;
+    size_t words   = RND_bitArrayWords(bitarray->size),
+           nblocks = (bitarray->size + RND_BITARRAY_BLOCK_BITS - 1) / RND_BITARRAY_BLOCK_BITS,
+           nsupers = (bitarray->size + RND_BITARRAY_SUPERBLOCK_BITS - 1) / RND_BITARRAY_SUPERBLOCK_BITS,
+           count   = RND_bitArrayPopcount(bitarray->bits, words),
+           nsamples = (count + RND_BITARRAY_SELECT_SAMPLE - 1) / RND_BITARRAY_SELECT_SAMPLE;
+    uint64_t *supers;
+    uint16_t *blocks;
+    size_t *samples;
+    if (!(supers = (uint64_t*)realloc(index->supers, (nsupers + 1) * sizeof(uint64_t)))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    index->supers = supers;
+    if (!(blocks = (uint16_t*)realloc(index->blocks, (nblocks + 1) * sizeof(uint16_t)))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    index->blocks = blocks;
+    if (!(samples = (size_t*)realloc(index->samples, (nsamples + 1) * sizeof(size_t)))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    index->samples = samples;
+
+    size_t total = 0, sampled = 0;
+    for (size_t b = 0; b < nblocks; b++) {
+        if (b % RND_BITARRAY_SUPERBLOCK_BLOCKS == 0) {
+            supers[b / RND_BITARRAY_SUPERBLOCK_BLOCKS] = total;
+        }
+        blocks[b] = total - supers[b / RND_BITARRAY_SUPERBLOCK_BLOCKS];
+        size_t first = b * RND_BITARRAY_BLOCK_WORDS,
+               last  = (first + RND_BITARRAY_BLOCK_WORDS < words)? first + RND_BITARRAY_BLOCK_WORDS : words;
+        total += RND_bitArrayPopcount(bitarray->bits + first, last - first);
+        while (sampled < nsamples && sampled * RND_BITARRAY_SELECT_SAMPLE < total) {
+            samples[sampled++] = b;
+        }
+    }
+    index->size  = bitarray->size;
+    index->count = total;
+    return 0;
+}
+
+// The number of set bits before a block
+static size_t RND_bitArrayIndexBlockRank(const RND_BitArrayIndex *index, size_t block)
+{
+    return index->supers[block / RND_BITARRAY_SUPERBLOCK_BLOCKS] + index->blocks[block];
+}
+
+size_t RND_bitArrayRank(const RND_BitArrayIndex *index, size_t position)
+{
+    if (!index) {
+        RND_ERROR("the index does not exist");
+        return 0;
+    }
+    if (position > index->size) {
+        RND_ERROR("position %lu out of bounds", position);
+        return 0;
+    }
+    if (position == index->size) {
+        return index->count;
+    }
+    const uint64_t *bits = index->bitarray->bits;
+    size_t block = position / RND_BITARRAY_BLOCK_BITS,
+           word  = position / 64,
+           first = block * RND_BITARRAY_BLOCK_WORDS;
+    size_t rank = RND_bitArrayIndexBlockRank(index, block) + RND_bitArrayPopcount(bits + first, word - first);
+    if (position % 64) {
+        rank += __builtin_popcountll(bits[word] & (((uint64_t)1 << (position % 64)) - 1));
+    }
+    return rank;
+}
+
+size_t RND_bitArraySelect(const RND_BitArrayIndex *index, size_t rank)
+{
+    if (!index) {
+        RND_ERROR("the index does not exist");
+        return 0;
+    }
+    if (rank >= index->count) {
+        return index->size;
+    }
+    // Binary search for the last block with at most rank bits before it between two samples
+    size_t sample = rank / RND_BITARRAY_SELECT_SAMPLE,
+           nsamples = (index->count + RND_BITARRAY_SELECT_SAMPLE - 1) / RND_BITARRAY_SELECT_SAMPLE,
+           lo = index->samples[sample],
+           hi = (sample + 1 < nsamples)? index->samples[sample + 1] : (index->size - 1) / RND_BITARRAY_BLOCK_BITS;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (RND_bitArrayIndexBlockRank(index, mid) <= rank) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    const uint64_t *bits = index->bitarray->bits;
+    size_t left = rank - RND_bitArrayIndexBlockRank(index, lo),
+           word = lo * RND_BITARRAY_BLOCK_WORDS;
+    for (;; word++) {
+        size_t count = __builtin_popcountll(bits[word]);
+        if (left < count) {
+            break;
+        }
+        left -= count;
+    }
+    uint64_t value = bits[word];
+    while (left--) {
+        value &= value - 1;
+    }
+    return word * 64 + __builtin_ctzll(value);
+}
+
+int RND_bitArrayIndexDestroy(RND_BitArrayIndex *index)
+{
+    if (!index) {
+        RND_WARN("the index does not exist");
+        return 1;
+    }
+    free(index->supers);
+    free(index->blocks);
+    free(index->samples);
+    free(index);
+    return 0;
+}
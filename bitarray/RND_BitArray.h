@@ -9,41 +9,104 @@
 #define RND_BITARRAY_H
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+/********************************************************
+ *                      CONSTANTS                       *
+ ********************************************************/
+
+/// The number of bits covered by one relative count of a @ref RND_BitArrayIndex.
+#define RND_BITARRAY_BLOCK_BITS 512
+
+/// The number of 64-bit words in a block of a @ref RND_BitArrayIndex.
+#define RND_BITARRAY_BLOCK_WORDS (RND_BITARRAY_BLOCK_BITS / 64)
+
+/// The number of bits covered by one absolute count of a @ref RND_BitArrayIndex.
+#define RND_BITARRAY_SUPERBLOCK_BITS 65536
+
+/// The number of blocks in a superblock of a @ref RND_BitArrayIndex.
+#define RND_BITARRAY_SUPERBLOCK_BLOCKS (RND_BITARRAY_SUPERBLOCK_BITS / RND_BITARRAY_BLOCK_BITS)
+
+/// Every how many set bits a @ref RND_BitArrayIndex remembers the block holding one.
+#define RND_BITARRAY_SELECT_SAMPLE 4096
+
+/// The maximum number of intermediate results and nested parentheses in an expression of @ref RND_bitArrayEval.
+#define RND_BITARRAY_EVAL_DEPTH 16
+
 /********************************************************
  *                     STRUCTURES                       *
  ********************************************************/
 
 /// @cond
 typedef struct RND_BitArray RND_BitArray;
+typedef struct RND_BitArrayIndex RND_BitArrayIndex;
 /// @endcond
 
-/// A bitarray  for compactly storing boolean values.
+/** A bitarray  for compactly storing boolean values.
+ *
+ * The bits are packed into 64-bit words, so that @ref RND_bitArrayAnd,
+ * @ref RND_bitArrayOr and @ref RND_bitArrayXor can process whole words
+ * (and several words at a time with SSE2 or AVX2, if the CPU supports
+ * them) no matter what the sizes of the bitarrays are.
+ */
 struct RND_BitArray
 {
     /** Holds the bitarray values
      *
-     * Every 8-bit element of this array is treated as
-     * 8 distinct bits when accessing the @ref RND_BitArray
+     * Every 64-bit element of this array is treated as
+     * 64 distinct bits when accessing the @ref RND_BitArray
      * struct with @ref RND_bitArrayGet, @ref RND_bitArraySet
-     * and @ref RND_bitArrayToggle.
+     * and @ref RND_bitArrayToggle. The bit with index @c i
+     * is stored in @c bits[i / 64] under the mask
+     * @c (1 << (i % 64)).
+     *
+     * All bits past the end of the bitarray, up to the end of
+     * the allocated memory, are always 0.
      */
-    uint8_t *bits;
+    uint64_t *bits;
     /** Stores the size of the bitarray (in bits)
      *
-     * The actual size of the @ref bits array is equal to
-     * ((@ref size + 7) / 8), because the array consists of
-     * 8-bit elements.
-     *
-     * Bitarrays with a @c (@ref size % 8 == 0) may outperform
-     * bitarrays with @c (@ref size % 8 != 0) on certain bit operations:
-     * - @ref RND_bitArrayAnd
-     * - @ref RND_bitArrayOr
-     * - @ref RND_bitArrayXor
+     * The number of elements of the @ref bits array in use is
+     * equal to ((@ref size + 63) / 64), because the array
+     * consists of 64-bit elements.
      */
     size_t size;
+    /// The number of 64-bit elements allocated for @ref bits.
+    size_t capacity;
+};
+
+/** A rank/select index over a bitarray.
+ *
+ * The index stores the number of set bits before every superblock of
+ * @ref RND_BITARRAY_SUPERBLOCK_BITS bits, and the number of set bits
+ * before every block of @ref RND_BITARRAY_BLOCK_BITS bits relative to
+ * its superblock, which takes about 3% of the bitarray's memory. This
+ * makes @ref RND_bitArrayRank O(1): one lookup in each table and a
+ * popcount of at most @ref RND_BITARRAY_BLOCK_WORDS words. Additionally,
+ * the block holding every @ref RND_BITARRAY_SELECT_SAMPLE-th set bit is
+ * remembered, so that @ref RND_bitArraySelect only has to binary search
+ * the blocks between two samples.
+ *
+ * The index is built from the bitarray's contents at the time of calling
+ * @ref RND_bitArrayIndexCreate or @ref RND_bitArrayIndexUpdate, and has
+ * to be updated after the bitarray is modified.
+ */
+struct RND_BitArrayIndex
+{
+    /// The indexed bitarray.
+    const RND_BitArray *bitarray;
+    /// The number of set bits before each superblock.
+    uint64_t *supers;
+    /// The number of set bits before each block, counted from the start of its superblock.
+    uint16_t *blocks;
+    /// The block holding every @ref RND_BITARRAY_SELECT_SAMPLE-th set bit.
+    size_t *samples;
+    /// The size of the bitarray at the time of the last update.
+    size_t size;
+    /// The total number of set bits at the time of the last update.
+    size_t count;
 };
 
 
@@ -63,6 +126,36 @@ struct RND_BitArray
  */
 RND_BitArray *RND_bitArrayCreate(size_t size);
 
+/** Changes the size of a bitarray.
+ *
+ * Bits added at the end are set to 0. If the new size does not fit
+ * in the allocated memory, the capacity is at least doubled, so that
+ * growing a bitarray bit by bit takes amortized O(1) time per bit.
+ * Shrinking a bitarray never frees memory.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] size The new size (in bits).
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray is a NULL-pointer
+ * - 2 - insufficient memory (the bitarray is left unchanged)
+ */
+int  RND_bitArrayResize(RND_BitArray *bitarray, size_t size);
+
+/** Appends a bit to the end of a bitarray.
+ *
+ * The size of the bitarray grows by 1, reallocating
+ * as described in @ref RND_bitArrayResize.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] value The value of the new bit (@c true or @c false).
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray is a NULL-pointer
+ * - 2 - insufficient memory
+ */
+int  RND_bitArrayPushBack(RND_BitArray *bitarray, bool value);
+
 /** Returns a selected bit's truth value.
  *
  * @param[in] bitarray A pointer to the bitarray.
@@ -109,12 +202,17 @@ int  RND_bitArraySet(RND_BitArray *bitarray, size_t index, bool value);
  * - if string length exceedes bitarray size, leftmost extra bits are ignored
  * - if string length is shorter than bitarray size, the extra space is padded with 0s from the left
  *
+ * The whole string is validated before the bitarray is modified, and the bits
+ * are then written a word at a time, so multi-megabit bitarrays can be loaded
+ * from text quickly. @ref RND_bitArrayFormat and @ref RND_bitArrayWrite do the
+ * opposite.
+ *
  * @param[inout] bitarray A pointer to the bitarray.
  * @param[in] format A formatted string denoting the new bitarray.
  * @returns
  * - 0 - success
  * - 1 - @p bitarray is a NULL-pointer
- * - 2 - invalid @p format string
+ * - 2 - invalid @p format string (@p bitarray is left unchanged)
  */
 int  RND_bitArraySetf(RND_BitArray *bitarray, const char *format);
 
@@ -129,6 +227,64 @@ int  RND_bitArraySetf(RND_BitArray *bitarray, const char *format);
  */
 int  RND_bitArrayToggle(RND_BitArray *bitarray, size_t index);
 
+/** Returns a selected bit's truth value without any checks.
+ *
+ * This is an inline version of @ref RND_bitArrayGet for tight
+ * loops, which compiles down to a load, a shift and a mask.
+ * @p bitarray must not be @c NULL and @p index must be in range,
+ * otherwise the behavior is undefined. If @c RND_BITARRAY_DEBUG
+ * is defined, this calls @ref RND_bitArrayGet instead, so that
+ * invalid accesses get reported.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @param[in] index The index of the targeted bit (starts at 0).
+ * @returns the value of the bit
+ */
+inline bool RND_bitArrayGetUnchecked(const RND_BitArray *bitarray, size_t index)
+{
+#ifdef RND_BITARRAY_DEBUG
+    return RND_bitArrayGet(bitarray, index);
+#else
+    return (bitarray->bits[index / 64] >> (index % 64)) & 1;
+#endif
+}
+
+/** Sets a selected bit to a chosen value without any checks.
+ *
+ * This is an inline version of @ref RND_bitArraySet. The same
+ * rules as for @ref RND_bitArrayGetUnchecked apply.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] index The index of the targeted bit (starts at 0).
+ * @param[in] value The value to set the bit to (@c true or @c false).
+ */
+inline void RND_bitArraySetUnchecked(RND_BitArray *bitarray, size_t index, bool value)
+{
+#ifdef RND_BITARRAY_DEBUG
+    RND_bitArraySet(bitarray, index, value);
+#else
+    uint64_t *word = bitarray->bits + index / 64;
+    *word = (*word & ~((uint64_t)1 << (index % 64))) | ((uint64_t)value << (index % 64));
+#endif
+}
+
+/** Toggles a selected bit to the opposite value without any checks.
+ *
+ * This is an inline version of @ref RND_bitArrayToggle. The same
+ * rules as for @ref RND_bitArrayGetUnchecked apply.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] index The index of the targeted bit (starts at 0).
+ */
+inline void RND_bitArrayToggleUnchecked(RND_BitArray *bitarray, size_t index)
+{
+#ifdef RND_BITARRAY_DEBUG
+    RND_bitArrayToggle(bitarray, index);
+#else
+    bitarray->bits[index / 64] ^= (uint64_t)1 << (index % 64);
+#endif
+}
+
 /** Frees all memory associated with a bitarray.
  *
  * This function should be called on every bitarray created by @ref
@@ -164,6 +320,46 @@ size_t RND_bitArraySize(const RND_BitArray *bitarray);
  */
 int  RND_bitArrayPrint(const RND_BitArray *bitarray);
 
+/** Writes a bitarray as a string of digits into a buffer.
+ *
+ * The string is in the format accepted by @ref RND_bitArraySetf, with
+ * a "0x", "0" or "0b" prefix for @p base 16, 8 or 2 respectively,
+ * and lowercase digits. Bit 0 is the most significant bit of the first
+ * digit, unless the size of the bitarray is not a multiple of the bits
+ * per digit, in which case the first digit is padded with leading 0s.
+ *
+ * Like @c snprintf, at most @p length characters are written including
+ * the terminating null character, and the return value is the length
+ * of the whole string, so a buffer of the right size can be allocated
+ * by first calling this function with @p buffer set to @c NULL.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @param[out] buffer A pointer to the buffer (may be @c NULL if @p length is 0).
+ * @param[in] length The size of @p buffer in characters.
+ * @param[in] base The base of the digits (2, 8 or 16).
+ * @returns
+ * - value > 0 - the length of the string, excluding the terminating null character
+ * - 0 - @p bitarray is a NULL-pointer or @p base is not supported
+ */
+size_t RND_bitArrayFormat(const RND_BitArray *bitarray, char *buffer, size_t length, int base);
+
+/** Writes a bitarray as a string of digits to a stream.
+ *
+ * The output is the same as that of @ref RND_bitArrayFormat, without
+ * the terminating null character. It is assembled in a buffer on the
+ * stack and written a few kilobytes at a time.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @param[inout] stream The stream to write to.
+ * @param[in] base The base of the digits (2, 8 or 16).
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray or @p stream is a NULL-pointer
+ * - 2 - @p base is not supported
+ * - 3 - writing to @p stream failed
+ */
+int  RND_bitArrayWrite(const RND_BitArray *bitarray, FILE *stream, int base);
+
 /** Performs the logical AND operation on two bitarrays.
  *
  * The result of the operation will overwrite the contents of
@@ -223,6 +419,49 @@ int  RND_bitArrayXor(RND_BitArray *dest, const RND_BitArray *src);
  */
 int  RND_bitArrayNegate(RND_BitArray *bitarray);
 
+/** Evaluates a boolean expression over several bitarrays in a single pass.
+ *
+ * The expression refers to the bitarrays in @p operands by letters,
+ * @c a being the first one, and may use the operators @c ~, @c &, @c ^
+ * and @c | (from the highest to the lowest precedence, like in C),
+ * parentheses and spaces. For example:
+ * @code
+ * const RND_BitArray *operands[] = { a, b, c, d };
+ * RND_bitArrayEval(result, NULL, "(a & b) | (c & ~d)", operands, 4);
+ *
+ * // The number of bits set in both a and b, without storing them anywhere
+ * size_t common;
+ * RND_bitArrayEval(NULL, &common, "a & b", operands, 2);
+ * @endcode
+ *
+ * Instead of combining whole bitarrays one operation at a time, the
+ * expression is evaluated for a small chunk of all operands at once,
+ * which stays in the cache, so every bitarray is read from memory only
+ * once and no temporary bitarrays are needed. @p dest may also be
+ * one of the operands.
+ *
+ * Operands of a different size than the result are aligned to the right,
+ * just like in @ref RND_bitArrayAnd, with missing bits read as 0.
+ *
+ * @param[inout] dest A pointer to the bitarray for storing the result
+ * @b OR @c NULL to only count the set bits of the result (which then
+ * has the size of the first operand).
+ * @param[out] count A pointer to where the number of set bits of
+ * the result will be stored @b OR @c NULL if not needed.
+ * @param[in] expression The expression to evaluate.
+ * @param[in] operands An array of pointers to the bitarrays.
+ * @param[in] operand_count The number of elements of @p operands (at most 26).
+ * @returns
+ * - 0 - success
+ * - 1 - both @p dest and @p count are NULL-pointers, @b OR @p expression
+ *   or @p operands is a NULL-pointer, @b OR an operand used by
+ *   @p expression is a NULL-pointer
+ * - 2 - invalid @p expression (for example, a letter past the last
+ *   operand or more than @ref RND_BITARRAY_EVAL_DEPTH levels of nesting)
+ * - 3 - insufficient memory
+ */
+int  RND_bitArrayEval(RND_BitArray *dest, size_t *count, const char *expression, const RND_BitArray *const *operands, size_t operand_count);
+
 /** Creates a deep copy of a bitarray.
  *
  * @param[in] bitarray A pointer to the bitarray.
@@ -232,4 +471,196 @@ int  RND_bitArrayNegate(RND_BitArray *bitarray);
  */
 RND_BitArray *RND_bitArrayCopy(const RND_BitArray *bitarray);
 
+/** Sets a range of bits to true.
+ *
+ * The partial words on both ends of the range are updated with
+ * masks and the whole words in between are written at once, which
+ * is much faster than calling @ref RND_bitArraySet for every bit.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] start The index of the first bit of the range.
+ * @param[in] length The number of bits in the range.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray is a NULL-pointer
+ * - 2 - the range does not fit in the bitarray
+ */
+int  RND_bitArraySetRange(RND_BitArray *bitarray, size_t start, size_t length);
+
+/** Sets a range of bits to false.
+ *
+ * Works just like @ref RND_bitArraySetRange.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] start The index of the first bit of the range.
+ * @param[in] length The number of bits in the range.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray is a NULL-pointer
+ * - 2 - the range does not fit in the bitarray
+ */
+int  RND_bitArrayClearRange(RND_BitArray *bitarray, size_t start, size_t length);
+
+/** Toggles every bit in a range to the opposite value.
+ *
+ * Works just like @ref RND_bitArraySetRange.
+ *
+ * @param[inout] bitarray A pointer to the bitarray.
+ * @param[in] start The index of the first bit of the range.
+ * @param[in] length The number of bits in the range.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray is a NULL-pointer
+ * - 2 - the range does not fit in the bitarray
+ */
+int  RND_bitArrayFlipRange(RND_BitArray *bitarray, size_t start, size_t length);
+
+/** Copies a range of bits from one bitarray to another.
+ *
+ * The bits are copied a word at a time, no matter how the
+ * two ranges are aligned. @p dest and @p src may be the same
+ * bitarray, in which case the ranges may overlap.
+ *
+ * @param[inout] dest A pointer to the destination bitarray.
+ * @param[in] dest_start The index of the first bit to overwrite in @p dest.
+ * @param[in] src A pointer to the source bitarray.
+ * @param[in] src_start The index of the first bit to copy from @p src.
+ * @param[in] length The number of bits to copy.
+ * @returns
+ * - 0 - success
+ * - 1 - @p dest or @p src is a NULL-pointer
+ * - 2 - one of the ranges does not fit in its bitarray
+ */
+int  RND_bitArrayCopyRange(RND_BitArray *dest, size_t dest_start, const RND_BitArray *src, size_t src_start, size_t length);
+
+/** Returns the number of bits set to true in a bitarray.
+ *
+ * The bits are counted a whole word at a time, with the @c popcnt
+ * instruction if the CPU supports it.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @returns
+ * - the number of set bits - success
+ * - 0 - @p bitarray is a NULL-pointer (or no bit is set)
+ */
+size_t RND_bitArrayCount(const RND_BitArray *bitarray);
+
+/** Returns the index of the first bit with a given value.
+ *
+ * Whole words are skipped at a time, so that scanning
+ * a sparse bitarray takes time proportional to its size
+ * in words rather than bits.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @param[in] value The value to look for (@c true or @c false).
+ * @returns
+ * - the index of the first bit equal to @p value - success
+ * - the size of the bitarray - no bit is equal to @p value
+ * - 0 - @p bitarray is a NULL-pointer
+ */
+size_t RND_bitArrayFindFirst(const RND_BitArray *bitarray, bool value);
+
+/** Returns the index of the next bit with a given value.
+ *
+ * Together with @ref RND_bitArrayFindFirst, this allows
+ * iterating over all set (or cleared) bits:
+ * @code
+ * for (size_t i = RND_bitArrayFindFirst(bits, true); i < bits->size; i = RND_bitArrayFindNext(bits, i, true)) {
+ *     // ...
+ * }
+ * @endcode
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @param[in] index The index after which to start looking.
+ * @param[in] value The value to look for (@c true or @c false).
+ * @returns
+ * - the index of the first bit after @p index equal to @p value - success
+ * - the size of the bitarray - no such bit (or @p index out of range)
+ * - 0 - @p bitarray is a NULL-pointer
+ */
+size_t RND_bitArrayFindNext(const RND_BitArray *bitarray, size_t index, bool value);
+
+/** Passes the index of each set bit of a bitarray to a custom function.
+ *
+ * The bits are visited in ascending order. Cleared bits cost
+ * nothing beyond reading their word, so this runs in time
+ * proportional to the number of words plus the number of set bits.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @param[in] map A pointer to a function which intakes the index
+ * of a set bit (@c size_t) and @p arg. The function must return 0
+ * for success, and any other value for failure.
+ * @param[in] arg Any pointer, passed directly to @p map.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitarray or @p map is @c NULL
+ * - 2 - some @p map returned non-0 (this means that
+ *   mapping the bitarray was interrupted)
+ */
+int  RND_bitArrayMap(const RND_BitArray *bitarray, int (*map)(size_t, void*), void *arg);
+
+/** Builds a new rank/select index over a bitarray and returns its pointer.
+ *
+ * Building the index takes a single pass over the bitarray. The
+ * bitarray must outlive the index.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @returns
+ * - the new index's address - success
+ * - @c NULL - insufficient memory @b OR @p bitarray is a NULL-pointer
+ */
+RND_BitArrayIndex *RND_bitArrayIndexCreate(const RND_BitArray *bitarray);
+
+/** Rebuilds an index after its bitarray has been modified.
+ *
+ * The memory of the index is reused if possible.
+ *
+ * @param[inout] index A pointer to the index.
+ * @returns
+ * - 0 - success
+ * - 1 - @p index is a NULL-pointer
+ * - 2 - insufficient memory (the index must not be used until
+ *   a successful update)
+ */
+int  RND_bitArrayIndexUpdate(RND_BitArrayIndex *index);
+
+/** Returns the number of set bits before a position in O(1).
+ *
+ * @param[in] index A pointer to the index.
+ * @param[in] position The index of a bit (starts at 0). Passing
+ * the size of the bitarray returns the total number of set bits.
+ * @returns
+ * - the number of set bits with indices lower than @p position - success
+ * - 0 - @p index is a NULL-pointer or @p position out of range
+ * (an appropriate error message is printed to @c stderr)
+ */
+size_t RND_bitArrayRank(const RND_BitArrayIndex *index, size_t position);
+
+/** Returns the position of the set bit with a given rank.
+ *
+ * This is the inverse of @ref RND_bitArrayRank, i.e. for every
+ * set bit @c i, @c RND_bitArraySelect(index, RND_bitArrayRank(index, i))
+ * is equal to @c i.
+ *
+ * @param[in] index A pointer to the index.
+ * @param[in] rank The number of set bits preceding the wanted one
+ * (0 finds the first set bit).
+ * @returns
+ * - the index of the wanted bit - success
+ * - @ref RND_BitArrayIndex::size - there are not enough set bits
+ * - 0 - @p index is a NULL-pointer
+ */
+size_t RND_bitArraySelect(const RND_BitArrayIndex *index, size_t rank);
+
+/** Frees all memory associated with an index.
+ *
+ * The indexed bitarray is not affected.
+ *
+ * @param[in] index A pointer to the index.
+ * @returns
+ * - 0 - success
+ * - 1 - @p index is a NULL-pointer
+ */
+int  RND_bitArrayIndexDestroy(RND_BitArrayIndex *index);
+
 #endif /* RND_BITARRAY_H */
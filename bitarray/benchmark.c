@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <RND_BitArray.h>
+#include <RND_Utils.h>
+
+#define SIZE    (1 << 23)
+#define REPEATS 20
+
+/* Runs RND_bitArrayAnd, RND_bitArrayOr and RND_bitArrayXor on two
+ * multi-megabit bitarrays, once with both sizes a multiple of 64 and
+ * once with sizes that are not even a multiple of 8, which used to make
+ * these functions fall back to a loop over single bits. The result of
+ * every operation is checked against such a bit-by-bit loop, which is
+ * timed as well for comparison. Then, the checked accessors are
+ * compared against the inline unchecked ones, and a bitarray is dumped
+ * to and loaded from a hexadecimal string. Last, (a & b) | (c & ~d) and
+ * the number of bits set in a & b are computed one operation at a time
+ * with temporary copies and in one pass with RND_bitArrayEval.
+ */
+
+typedef int (*Operation)(RND_BitArray*, const RND_BitArray*);
+
+void randomize(RND_BitArray *bitarray)
+{
+    for (size_t i = 0; i < RND_bitArraySize(bitarray); i++) {
+        RND_bitArraySet(bitarray, i, rand() & 1);
+    }
+}
+
+// Combine two bitarrays aligned to the right, one bit at a time
+void bitByBit(RND_BitArray *dest, const RND_BitArray *src, int op)
+{
+    size_t dsize = RND_bitArraySize(dest), ssize = RND_bitArraySize(src);
+    for (size_t i = 0; i < dsize; i++) {
+        bool a = RND_bitArrayGet(dest, i),
+             b = (i + ssize >= dsize)? RND_bitArrayGet(src, i + ssize - dsize) : false;
+        RND_bitArraySet(dest, i, (op == 0)? a && b : (op == 1)? a || b : a != b);
+    }
+}
+
+void run(size_t dsize, size_t ssize)
+{
+    static const char *names[] = { "and", "or", "xor" };
+    static const Operation ops[] = { RND_bitArrayAnd, RND_bitArrayOr, RND_bitArrayXor };
+    RND_BitArray *dest = RND_bitArrayCreate(dsize), *src = RND_bitArrayCreate(ssize);
+    randomize(dest);
+    randomize(src);
+    for (int op = 0; op < 3; op++) {
+        RND_BitArray *expected = RND_bitArrayCopy(dest);
+        double start = RND_getWallTime_usec();
+        bitByBit(expected, src, op);
+        double mid = RND_getWallTime_usec();
+        for (int i = 0; i < REPEATS; i++) {
+            ops[op](dest, src);
+        }
+        double end = RND_getWallTime_usec();
+        // Applying the operation an even number of times is the same as once for and/or and no-op for xor
+        if (op == 2) {
+            ops[op](dest, src);
+        }
+        for (size_t i = 0; i < dsize; i++) {
+            if (RND_bitArrayGet(dest, i) != RND_bitArrayGet(expected, i)) {
+                printf("%s: mismatch at bit %lu\n", names[op], i);
+                exit(EXIT_FAILURE);
+            }
+        }
+        double bytes = 2.0 * ((dsize + 7) / 8) + (ssize + 7) / 8;
+        printf("%9lu | %9lu | %-3s | %12.2f | %12.2f | %10.2f\n", dsize, ssize, names[op],
+                (mid - start) / 1000, (end - mid) / 1000 / REPEATS, bytes * REPEATS / (end - mid) / 1000);
+        RND_bitArrayDestroy(expected);
+    }
+    RND_bitArrayDestroy(dest);
+    RND_bitArrayDestroy(src);
+}
+
+/* Walks over every bit, first copying one bitarray into another and
+ * then counting set bits, with the checked and the unchecked accessors.
+ */
+void runAccess()
+{
+    RND_BitArray *src = RND_bitArrayCreate(SIZE), *dest = RND_bitArrayCreate(SIZE);
+    randomize(src);
+    size_t checked = 0, unchecked = 0;
+    double start = RND_getWallTime_usec();
+    for (size_t i = 0; i < SIZE; i++) {
+        RND_bitArraySet(dest, i, RND_bitArrayGet(src, i));
+    }
+    double mid1 = RND_getWallTime_usec();
+    for (size_t i = 0; i < SIZE; i++) {
+        checked += RND_bitArrayGet(dest, i);
+    }
+    double mid2 = RND_getWallTime_usec();
+    for (size_t i = 0; i < SIZE; i++) {
+        RND_bitArraySetUnchecked(dest, i, RND_bitArrayGetUnchecked(src, i));
+    }
+    double mid3 = RND_getWallTime_usec();
+    for (size_t i = 0; i < SIZE; i++) {
+        unchecked += RND_bitArrayGetUnchecked(dest, i);
+    }
+    double end = RND_getWallTime_usec();
+    if (checked != unchecked || checked != RND_bitArrayCount(src)) {
+        printf("access: counts differ\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("%-9s | %10.2f | %10.2f\n", "checked", (mid1 - start) / 1000, (mid2 - mid1) / 1000);
+    printf("%-9s | %10.2f | %10.2f\n", "unchecked", (mid3 - mid2) / 1000, (end - mid3) / 1000);
+    RND_bitArrayDestroy(src);
+    RND_bitArrayDestroy(dest);
+}
+
+/* Converts a bitarray to a hexadecimal string and back, checking that
+ * the result matches the original.
+ */
+void runText()
+{
+    RND_BitArray *src = RND_bitArrayCreate(SIZE), *dest = RND_bitArrayCreate(SIZE);
+    randomize(src);
+    size_t length = RND_bitArrayFormat(src, NULL, 0, 16);
+    char *text = malloc(length + 1);
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        RND_bitArrayFormat(src, text, length + 1, 16);
+    }
+    double mid = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        RND_bitArraySetf(dest, text);
+    }
+    double end = RND_getWallTime_usec();
+    for (size_t i = 0; i < SIZE; i++) {
+        if (RND_bitArrayGet(dest, i) != RND_bitArrayGet(src, i)) {
+            printf("text: mismatch at bit %lu\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    printf("%-6s | %9.2f | %10.2f\n", "format", (mid - start) / 1000 / REPEATS, length * REPEATS / (mid - start));
+    printf("%-6s | %9.2f | %10.2f\n", "setf", (end - mid) / 1000 / REPEATS, length * REPEATS / (end - mid));
+    free(text);
+    RND_bitArrayDestroy(src);
+    RND_bitArrayDestroy(dest);
+}
+
+void runEval()
+{
+    RND_BitArray *a = RND_bitArrayCreate(SIZE), *b = RND_bitArrayCreate(SIZE),
+                 *c = RND_bitArrayCreate(SIZE), *d = RND_bitArrayCreate(SIZE),
+                 *fused = RND_bitArrayCreate(SIZE), *stepwise = NULL, *temp = NULL;
+    const RND_BitArray *operands[] = { a, b, c, d };
+    randomize(a);
+    randomize(b);
+    randomize(c);
+    randomize(d);
+    size_t count_stepwise = 0, count_fused = 0;
+
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        if (stepwise) {
+            RND_bitArrayDestroy(stepwise);
+            RND_bitArrayDestroy(temp);
+        }
+        stepwise = RND_bitArrayCopy(a);
+        RND_bitArrayAnd(stepwise, b);
+        temp = RND_bitArrayCopy(d);
+        RND_bitArrayNegate(temp);
+        RND_bitArrayAnd(temp, c);
+        RND_bitArrayOr(stepwise, temp);
+    }
+    double mid1 = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        RND_bitArrayEval(fused, NULL, "(a & b) | (c & ~d)", operands, 4);
+    }
+    double mid2 = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        if (temp) {
+            RND_bitArrayDestroy(temp);
+        }
+        temp = RND_bitArrayCopy(a);
+        RND_bitArrayAnd(temp, b);
+        count_stepwise = RND_bitArrayCount(temp);
+    }
+    double mid3 = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        RND_bitArrayEval(NULL, &count_fused, "a & b", operands, 2);
+    }
+    double end = RND_getWallTime_usec();
+
+    for (size_t i = 0; i < SIZE; i++) {
+        if (RND_bitArrayGet(fused, i) != RND_bitArrayGet(stepwise, i)) {
+            printf("eval: mismatch at bit %lu\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (count_fused != count_stepwise) {
+        printf("eval: counts differ\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("%-18s | %13.2f | %10.2f\n", "(a & b) | (c & ~d)", (mid1 - start) / 1000 / REPEATS, (mid2 - mid1) / 1000 / REPEATS);
+    printf("%-18s | %13.2f | %10.2f\n", "count(a & b)", (mid3 - mid2) / 1000 / REPEATS, (end - mid3) / 1000 / REPEATS);
+    RND_bitArrayDestroy(a);
+    RND_bitArrayDestroy(b);
+    RND_bitArrayDestroy(c);
+    RND_bitArrayDestroy(d);
+    RND_bitArrayDestroy(fused);
+    RND_bitArrayDestroy(stepwise);
+    RND_bitArrayDestroy(temp);
+}
+
+int main(int argc, char **argv)
+{
+    srand(1);
+    printf("     DEST |       SRC | OP  |  BY BIT (ms) | BY WORD (ms) | WORD (GB/s)\n");
+    run(SIZE, SIZE);
+    run(SIZE + 5, SIZE - 3);
+    run(SIZE - 3, SIZE + 13);
+    printf("\nACCESS    |  COPY (ms) | COUNT (ms)\n");
+    runAccess();
+    printf("\nHEX    | TIME (ms) | TEXT (MB/s)\n");
+    runText();
+    printf("\nEXPRESSION         | STEPWISE (ms) | FUSED (ms)\n");
+    runEval();
+
+    return EXIT_SUCCESS;
+}
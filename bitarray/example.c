@@ -10,6 +10,11 @@ int main(int argc, char **argv)
     RND_bitArrayPrint(arr1);
     RND_bitArraySetf(arr1, "0b 1011 1010 1100 001");
     RND_bitArrayPrint(arr1);
+    char hex[16];
+    RND_bitArrayFormat(arr1, hex, sizeof hex, 16);
+    printf("%s = ", hex);
+    RND_bitArrayWrite(arr1, stdout, 8);
+    printf("\n");
     printf("----------------\n");
     RND_bitArraySetf(arr2, "0b0101 0110");
     RND_bitArraySetf(arr3, "0b0011 1101");
@@ -37,6 +42,37 @@ int main(int argc, char **argv)
     printf("~=\n");
     RND_bitArrayNegate(arr2);
     RND_bitArrayPrint(arr2);
+    printf("----------------\n");
+    RND_BitArrayIndex *index = RND_bitArrayIndexCreate(arr1);
+    RND_bitArrayPrint(arr1);
+    printf("count = %lu\n", RND_bitArrayCount(arr1));
+    printf("rank(8) = %lu\n", RND_bitArrayRank(index, 8));
+    printf("select(4) = %lu\n", RND_bitArraySelect(index, 4));
+    RND_bitArrayIndexDestroy(index);
+    printf("set bits:");
+    for (size_t i = RND_bitArrayFindFirst(arr1, true); i < arr1->size; i = RND_bitArrayFindNext(arr1, i, true)) {
+        printf(" %lu", i);
+    }
+    printf("\nfirst clear bit: %lu\n", RND_bitArrayFindFirst(arr1, false));
+    printf("----------------\n");
+    RND_bitArraySetRange(arr1, 0, 4);
+    RND_bitArrayFlipRange(arr1, 8, 8);
+    RND_bitArrayCopyRange(arr1, 16, arr1, 0, 3);
+    RND_bitArrayPrint(arr1);
+    printf("----------------\n");
+    RND_bitArrayResize(arr1, 24);
+    RND_bitArrayPushBack(arr1, true);
+    RND_bitArrayPrint(arr1);
+    printf("----------------\n");
+    const RND_BitArray *operands[] = { arr2, arr3 };
+    size_t count;
+    RND_bitArraySetf(arr2, "0b0101 0110");
+    RND_bitArrayPrint(arr2);
+    RND_bitArrayPrint(arr3);
+    printf("(a | b) & ~(a & b) =\n");
+    RND_bitArrayEval(arr2, &count, "(a | b) & ~(a & b)", operands, 2);
+    RND_bitArrayPrint(arr2);
+    printf("count = %lu\n", count);
 
     RND_bitArrayDestroy(arr1);
     RND_bitArrayDestroy(arr2);
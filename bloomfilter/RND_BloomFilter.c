@@ -0,0 +1,306 @@
+#include <malloc.h>
+#include <string.h>
+#include <math.h>
+#include <RND_ErrMsg.h>
+#include <RND_HashMap.h>
+#include "RND_BloomFilter.h"
+
+// The number of 64-bit words in a block of a blocked filter
+#define RND_BLOOM_FILTER_BLOCK_WORDS (RND_BLOOM_FILTER_BLOCK_BITS / 64)
+
+/* Scramble a hash value, so that the indices derived from it depend on
+ * all of its bits even if the hash function itself mixes them poorly
+ * (this is the finalizer of MurmurHash3).
+ */
+static uint64_t RND_bloomFilterMix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* Derive the two hashes of a key for double hashing, where the i-th
+ * index of a key is h1 + i * h2 (modulo the size of the filter).
+ */
+static void RND_bloomFilterHash(const RND_BloomFilter *filter, const char *key, uint64_t *h1, uint64_t *h2)
+{
+    uint64_t h = filter->hash(key, SIZE_MAX);
+    *h1 = RND_bloomFilterMix(h);
+    *h2 = RND_bloomFilterMix(h ^ 0x9e3779b97f4a7c15ULL);
+}
+
+/* Compute the first index of a key in a plain or counting filter and
+ * the step to its next ones. The size of these filters is a prime, so
+ * any step between 1 and size - 1 is coprime to it, and the indices
+ * are all different unless there are more hashes than bits.
+ */
+static size_t RND_bloomFilterFirst(const RND_BloomFilter *filter, const char *key, size_t *step)
+{
+    size_t size = filter->bits->size;
+    uint64_t h1, h2;
+    RND_bloomFilterHash(filter, key, &h1, &h2);
+    *step = h2 % (size - 1) + 1;
+    return h1 % size;
+}
+
+// Advance to the next index of a key, which is (index + step) % size without overflow
+static size_t RND_bloomFilterNext(const RND_BloomFilter *filter, size_t index, size_t step)
+{
+    size_t size = filter->bits->size;
+    return (index >= size - step)? index - (size - step) : index + step;
+}
+
+/* Compute the block of a key in a blocked filter and the mask of its
+ * bits in every word of the block. The step is odd, so the positions
+ * within the block are all different.
+ */
+static uint64_t *RND_bloomFilterBlock(const RND_BloomFilter *filter, const char *key, uint64_t *masks)
+{
+    uint64_t h1, h2;
+    RND_bloomFilterHash(filter, key, &h1, &h2);
+    size_t block = h1 % (filter->bits->size / RND_BLOOM_FILTER_BLOCK_BITS);
+    unsigned int position = h2 % RND_BLOOM_FILTER_BLOCK_BITS,
+                 step = ((h2 >> 32) % RND_BLOOM_FILTER_BLOCK_BITS) | 1;
+    memset(masks, 0, sizeof(uint64_t) * RND_BLOOM_FILTER_BLOCK_WORDS);
+    for (unsigned int i = 0; i < filter->hashes; i++) {
+        masks[position / 64] |= (uint64_t)1 << (position % 64);
+        position = (position + step) % RND_BLOOM_FILTER_BLOCK_BITS;
+    }
+    return filter->bits->bits + block * RND_BLOOM_FILTER_BLOCK_WORDS;
+}
+
+// The smallest prime that is not less than n (and at least 2)
+static size_t RND_bloomFilterPrime(size_t n)
+{
+    if (n <= 2) {
+        return 2;
+    }
+    for (n |= 1;; n += 2) {
+        size_t d = 3;
+        while (d <= n / d && n % d) {
+            d += 2;
+        }
+        if (d > n / d) {
+            return n;
+        }
+    }
+}
+
+static unsigned int RND_bloomFilterCounter(const RND_BloomFilter *filter, size_t index)
+{
+    return (filter->counters[index / 2] >> (index % 2 * 4)) & 0xf;
+}
+
+static void RND_bloomFilterSetCounter(RND_BloomFilter *filter, size_t index, unsigned int value)
+{
+    uint8_t *byte = filter->counters + index / 2;
+    *byte = (*byte & ~(0xf << (index % 2 * 4))) | (value << (index % 2 * 4));
+}
+
+RND_BloomFilter *RND_bloomFilterCreate(size_t size, unsigned int hashes, uint8_t type, size_t (*hash)(const char *key, size_t size))
+{
+    if (!size || !hashes) {
+        RND_ERROR("the size and number of hashes must not be 0");
+        return NULL;
+    }
+    if (type != RND_BLOOM_FILTER_PLAIN && type != RND_BLOOM_FILTER_BLOCKED && type != RND_BLOOM_FILTER_COUNTING) {
+        RND_ERROR("invalid filter type %u", type);
+        return NULL;
+    }
+    if (type == RND_BLOOM_FILTER_BLOCKED) {
+        if (size % RND_BLOOM_FILTER_BLOCK_BITS) {
+            size += RND_BLOOM_FILTER_BLOCK_BITS - size % RND_BLOOM_FILTER_BLOCK_BITS;
+        }
+    } else {
+        size = RND_bloomFilterPrime(size);
+    }
+
+    RND_BloomFilter *new;
+    if (!(new = (RND_BloomFilter*)malloc(sizeof(RND_BloomFilter)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    if (!(new->bits = RND_bitArrayCreate(size))) {
+        RND_ERROR("RND_bitArrayCreate");
+        free(new);
+        return NULL;
+    }
+    new->counters = NULL;
+    if (type == RND_BLOOM_FILTER_COUNTING && !(new->counters = (uint8_t*)calloc((size + 1) / 2, 1))) {
+        RND_ERROR("calloc");
+        RND_bitArrayDestroy(new->bits);
+        free(new);
+        return NULL;
+    }
+    new->hashes = hashes;
+    new->type = type;
+    new->hash = hash? hash : RND_hashMapDefaultHashFunction;
+    return new;
+}
+
+int RND_bloomFilterSuggest(size_t items, double rate, size_t *size, unsigned int *hashes)
+{
+    if (!size || !hashes) {
+        RND_ERROR("the output pointers must not be NULL");
+        return 1;
+    }
+    if (!items || !(rate > 0 && rate < 1)) {
+        RND_ERROR("invalid number of items or false positive rate");
+        return 2;
+    }
+    double ln2 = log(2), bits = ceil(-(double)items * log(rate) / (ln2 * ln2));
+    *size = (size_t)bits;
+    *hashes = (unsigned int)round(bits / items * ln2);
+    if (*hashes == 0) {
+        *hashes = 1;
+    }
+    return 0;
+}
+
+int RND_bloomFilterAdd(RND_BloomFilter *filter, const char *key)
+{
+    if (!filter) {
+        RND_ERROR("the filter does not exist");
+        return 1;
+    }
+    if (!key) {
+        RND_ERROR("the key does not exist");
+        return 1;
+    }
+    if (filter->type == RND_BLOOM_FILTER_BLOCKED) {
+        uint64_t masks[RND_BLOOM_FILTER_BLOCK_WORDS];
+        uint64_t *block = RND_bloomFilterBlock(filter, key, masks);
+        for (int i = 0; i < RND_BLOOM_FILTER_BLOCK_WORDS; i++) {
+            block[i] |= masks[i];
+        }
+        return 0;
+    }
+    size_t step, index = RND_bloomFilterFirst(filter, key, &step);
+    for (unsigned int i = 0; i < filter->hashes; i++) {
+        filter->bits->bits[index / 64] |= (uint64_t)1 << (index % 64);
+        if (filter->counters) {
+            unsigned int counter = RND_bloomFilterCounter(filter, index);
+            if (counter < RND_BLOOM_FILTER_COUNTER_MAX) {
+                RND_bloomFilterSetCounter(filter, index, counter + 1);
+            }
+        }
+        index = RND_bloomFilterNext(filter, index, step);
+    }
+    return 0;
+}
+
+bool RND_bloomFilterContains(const RND_BloomFilter *filter, const char *key)
+{
+    if (!filter) {
+        RND_ERROR("the filter does not exist");
+        return false;
+    }
+    if (!key) {
+        RND_ERROR("the key does not exist");
+        return false;
+    }
+    if (filter->type == RND_BLOOM_FILTER_BLOCKED) {
+        uint64_t masks[RND_BLOOM_FILTER_BLOCK_WORDS], missing = 0;
+        const uint64_t *block = RND_bloomFilterBlock(filter, key, masks);
+        for (int i = 0; i < RND_BLOOM_FILTER_BLOCK_WORDS; i++) {
+            missing |= masks[i] & ~block[i];
+        }
+        return !missing;
+    }
+    size_t step, index = RND_bloomFilterFirst(filter, key, &step);
+    for (unsigned int i = 0; i < filter->hashes; i++) {
+        if (!((filter->bits->bits[index / 64] >> (index % 64)) & 1)) {
+            return false;
+        }
+        index = RND_bloomFilterNext(filter, index, step);
+    }
+    return true;
+}
+
+int RND_bloomFilterRemove(RND_BloomFilter *filter, const char *key)
+{
+    if (!filter) {
+        RND_ERROR("the filter does not exist");
+        return 1;
+    }
+    if (!key) {
+        RND_ERROR("the key does not exist");
+        return 1;
+    }
+    if (filter->type != RND_BLOOM_FILTER_COUNTING) {
+        RND_ERROR("only counting filters support removal");
+        return 2;
+    }
+    // Check all the counters before decrementing any, so a missing key leaves the filter unchanged
+    size_t step, first = RND_bloomFilterFirst(filter, key, &step), index = first;
+    for (unsigned int i = 0; i < filter->hashes; i++) {
+        if (!RND_bloomFilterCounter(filter, index)) {
+            return 3;
+        }
+        index = RND_bloomFilterNext(filter, index, step);
+    }
+    index = first;
+    for (unsigned int i = 0; i < filter->hashes; i++) {
+        unsigned int counter = RND_bloomFilterCounter(filter, index);
+        if (counter != 0 && counter != RND_BLOOM_FILTER_COUNTER_MAX) {
+            RND_bloomFilterSetCounter(filter, index, counter - 1);
+            if (counter == 1) {
+                filter->bits->bits[index / 64] &= ~((uint64_t)1 << (index % 64));
+            }
+        }
+        index = RND_bloomFilterNext(filter, index, step);
+    }
+    return 0;
+}
+
+double RND_bloomFilterRate(const RND_BloomFilter *filter)
+{
+    if (!filter) {
+        RND_ERROR("the filter does not exist");
+        return 0;
+    }
+    const RND_BitArray *bits = filter->bits;
+    if (filter->type != RND_BLOOM_FILTER_BLOCKED) {
+        return pow((double)RND_bitArrayCount(bits) / bits->size, filter->hashes);
+    }
+
+    // A key is only checked against its own block, so average over the blocks
+    double rate = 0;
+    size_t blocks = bits->size / RND_BLOOM_FILTER_BLOCK_BITS;
+    for (size_t i = 0; i < blocks; i++) {
+        unsigned int count = 0;
+        for (int j = 0; j < RND_BLOOM_FILTER_BLOCK_WORDS; j++) {
+            count += __builtin_popcountll(bits->bits[i * RND_BLOOM_FILTER_BLOCK_WORDS + j]);
+        }
+        rate += pow((double)count / RND_BLOOM_FILTER_BLOCK_BITS, filter->hashes);
+    }
+    return rate / blocks;
+}
+
+int RND_bloomFilterClear(RND_BloomFilter *filter)
+{
+    if (!filter) {
+        RND_ERROR("the filter does not exist");
+        return 1;
+    }
+    RND_bitArrayClearRange(filter->bits, 0, filter->bits->size);
+    if (filter->counters) {
+        memset(filter->counters, 0, (filter->bits->size + 1) / 2);
+    }
+    return 0;
+}
+
+int RND_bloomFilterDestroy(RND_BloomFilter *filter)
+{
+    if (!filter) {
+        RND_WARN("the filter does not exist");
+        return 1;
+    }
+    RND_bitArrayDestroy(filter->bits);
+    free(filter->counters);
+    free(filter);
+    return 0;
+}
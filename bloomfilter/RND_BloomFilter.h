@@ -0,0 +1,188 @@
+/** @file
+ * The header file of the RND_BloomFilter library.
+ *
+ * A Bloom filter is a compact, probabilistic set of strings. Checking
+ * whether a key is present may return a false positive, but never a
+ * false negative, which makes it a cheap test to put in front of a
+ * slower lookup (for example @c RND_hashMapGet) to skip it for most
+ * keys that are not there. Every key sets a handful of bits of an
+ * @ref RND_BitArray, chosen by double hashing over a single hash
+ * function with the same signature as the one of @c RND_HashMap.
+ *
+ * @example bloomfilter/example.c
+ * Here's an example usage of the RND_BloomFilter library.
+ */
+
+#ifndef RND_BLOOM_FILTER_H
+#define RND_BLOOM_FILTER_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <RND_BitArray.h>
+
+/********************************************************
+ *                      CONSTANTS                       *
+ ********************************************************/
+
+/// Filter type: the bits of a key are spread over the whole bitarray.
+#define RND_BLOOM_FILTER_PLAIN 0
+
+/// Filter type: the bits of a key all lie in one block of @ref RND_BLOOM_FILTER_BLOCK_BITS bits.
+#define RND_BLOOM_FILTER_BLOCKED 1
+
+/// Filter type: like @ref RND_BLOOM_FILTER_PLAIN, with a counter per bit to support removal.
+#define RND_BLOOM_FILTER_COUNTING 2
+
+/** The number of bits of a block of a blocked filter.
+ *
+ * This is the size of a typical cache line, so that adding or
+ * looking up a key touches a single cache line instead of one
+ * per hash, at the cost of a slightly higher false positive rate.
+ */
+#define RND_BLOOM_FILTER_BLOCK_BITS 512
+
+/// The largest value of a counter of a counting filter, which is never decremented.
+#define RND_BLOOM_FILTER_COUNTER_MAX 15
+
+/********************************************************
+ *                     STRUCTURES                       *
+ ********************************************************/
+
+/// @cond
+typedef struct RND_BloomFilter RND_BloomFilter;
+/// @endcond
+
+/** A Bloom filter of strings.
+ *
+ * A counting filter keeps a 4-bit counter per bit next to the
+ * bitarray, which holds whether each counter is non-zero, so
+ * lookups in all types of filters only ever read the bitarray.
+ * A counter that reaches @ref RND_BLOOM_FILTER_COUNTER_MAX sticks
+ * there, as it is no longer known how many keys it counts.
+ */
+struct RND_BloomFilter
+{
+    /// The bits of the filter.
+    RND_BitArray *bits;
+    /// The counters of a counting filter, two per byte (@c NULL for other types).
+    uint8_t *counters;
+    /// The number of bits set for each key.
+    unsigned int hashes;
+    /// The type of the filter.
+    uint8_t type;
+    /** The hash function used to convert keys into bit indices.
+     *
+     * It is always called with @c SIZE_MAX as @c size, so that it
+     * returns the whole hash value, from which the filter derives
+     * all @ref hashes indices.
+     */
+    size_t (*hash)(const char *key, size_t size);
+};
+
+/********************************************************
+ *                      FUNCTIONS                       *
+ ********************************************************/
+
+/** Allocates a new empty Bloom filter and returns its pointer.
+ *
+ * @param[in] size The number of bits of the filter (for a blocked
+ * filter, this is rounded up to a multiple of @ref RND_BLOOM_FILTER_BLOCK_BITS,
+ * and for other types, to a prime, so that the bits of a key are all different).
+ * @param[in] hashes The number of bits set for each key.
+ * @param[in] type The type of the filter (@ref RND_BLOOM_FILTER_PLAIN,
+ * @ref RND_BLOOM_FILTER_BLOCKED or @ref RND_BLOOM_FILTER_COUNTING).
+ * @param[in] hash A pointer to a @ref RND_BloomFilter::hash function
+ * for the new filter @b OR @c NULL for the default
+ * (@c RND_hashMapDefaultHashFunction).
+ * @returns
+ * - the new filter's address - success
+ * - @c NULL - insufficient memory @b OR @p size or @p hashes is 0
+ *   @b OR @p type is invalid
+ */
+RND_BloomFilter *RND_bloomFilterCreate(size_t size, unsigned int hashes, uint8_t type, size_t (*hash)(const char *key, size_t size));
+
+/** Computes the size and number of hashes of a filter for a target false positive rate.
+ *
+ * The results are meant to be passed to @ref RND_bloomFilterCreate,
+ * and are the optimal values for a plain filter. A blocked filter
+ * of the same size has a slightly higher false positive rate.
+ *
+ * @param[in] items The expected number of keys in the filter.
+ * @param[in] rate The target false positive rate (between 0 and 1, exclusive).
+ * @param[out] size The number of bits of the filter.
+ * @param[out] hashes The number of bits set for each key.
+ * @returns
+ * - 0 - success
+ * - 1 - @p size or @p hashes is a NULL-pointer
+ * - 2 - @p items is 0 or @p rate is out of range
+ */
+int  RND_bloomFilterSuggest(size_t items, double rate, size_t *size, unsigned int *hashes);
+
+/** Adds a key to a Bloom filter.
+ *
+ * @param[inout] filter A pointer to the filter.
+ * @param[in] key The key to add.
+ * @returns
+ * - 0 - success
+ * - 1 - @p filter or @p key is a NULL-pointer
+ */
+int  RND_bloomFilterAdd(RND_BloomFilter *filter, const char *key);
+
+/** Checks whether a key may be present in a Bloom filter.
+ *
+ * @param[in] filter A pointer to the filter.
+ * @param[in] key The key to look for.
+ * @returns
+ * - @c true - @p key may be present
+ * - @c false - @p key is not present @b OR @p filter or @p key is a NULL-pointer
+ */
+bool RND_bloomFilterContains(const RND_BloomFilter *filter, const char *key);
+
+/** Removes a key from a counting Bloom filter.
+ *
+ * Only keys that were added may be removed, as removing any other
+ * key that happens to be reported as present by @ref RND_bloomFilterContains
+ * would make the filter forget some of the keys that were added.
+ *
+ * @param[inout] filter A pointer to the filter.
+ * @param[in] key The key to remove.
+ * @returns
+ * - 0 - success
+ * - 1 - @p filter or @p key is a NULL-pointer
+ * - 2 - @p filter is not a counting filter
+ * - 3 - @p key is not present (the filter is left unchanged)
+ */
+int  RND_bloomFilterRemove(RND_BloomFilter *filter, const char *key);
+
+/** Estimates the current false positive rate of a Bloom filter.
+ *
+ * The estimate is based on the fraction of set bits, which
+ * makes it accurate regardless of how many keys were added.
+ *
+ * @param[in] filter A pointer to the filter.
+ * @returns
+ * - the probability that a key which is not present is reported as present - success
+ * - 0 - @p filter is a NULL-pointer (or filter is empty)
+ */
+double RND_bloomFilterRate(const RND_BloomFilter *filter);
+
+/** Removes all keys from a Bloom filter.
+ *
+ * @param[inout] filter A pointer to the filter.
+ * @returns
+ * - 0 - success
+ * - 1 - @p filter is a NULL-pointer
+ */
+int  RND_bloomFilterClear(RND_BloomFilter *filter);
+
+/** Frees all memory associated with a Bloom filter.
+ *
+ * @param[in] filter A pointer to the filter.
+ * @returns
+ * - 0 - success
+ * - 1 - @p filter is a NULL-pointer
+ */
+int  RND_bloomFilterDestroy(RND_BloomFilter *filter);
+
+#endif /* RND_BLOOM_FILTER_H */
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <string.h>
+#include <RND_BloomFilter.h>
+#include <RND_HashMap.h>
+#include <RND_Utils.h>
+
+#define COUNT 1000000
+#define RATE  0.01
+
+/* Adds COUNT keys to every type of filter sized for a false positive
+ * rate of RATE, then looks up COUNT other keys and reports how many
+ * of them were false positives, next to the filter's own estimate.
+ * A filter with any false negative is an error. The counting filter
+ * then has half of its keys removed and is checked again. Finally,
+ * the filter is put in front of RND_hashMapGet for the missing keys.
+ * RND_hashMapGet warns about every missing key, so stderr is silenced
+ * for that part (the formatting of the warnings is still timed).
+ */
+
+char keys[COUNT][16], others[COUNT][16];
+
+void run(const char *name, uint8_t type)
+{
+    size_t size;
+    unsigned int hashes;
+    RND_bloomFilterSuggest(COUNT, RATE, &size, &hashes);
+    RND_BloomFilter *filter = RND_bloomFilterCreate(size, hashes, type, NULL);
+    // Count the memory actually used, including the 4-bit counters of a counting filter
+    size_t bits = filter->bits->size;
+    if (type == RND_BLOOM_FILTER_COUNTING) {
+        bits += (filter->bits->size + 1) / 2 * 8;
+    }
+    double start = RND_getWallTime_usec();
+    for (size_t i = 0; i < COUNT; i++) {
+        RND_bloomFilterAdd(filter, keys[i]);
+    }
+    double mid = RND_getWallTime_usec();
+    size_t positives = 0;
+    for (size_t i = 0; i < COUNT; i++) {
+        positives += RND_bloomFilterContains(filter, others[i]);
+    }
+    double end = RND_getWallTime_usec();
+    for (size_t i = 0; i < COUNT; i++) {
+        if (!RND_bloomFilterContains(filter, keys[i])) {
+            printf("%s: false negative for %s\n", name, keys[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    printf("%-8s | %8.2f | %9.2f | %9.2f | %10.3f | %12.3f\n", name, (double)bits / COUNT,
+            (mid - start) * 1000 / COUNT, (end - mid) * 1000 / COUNT,
+            100.0 * positives / COUNT, 100 * RND_bloomFilterRate(filter));
+
+    if (type == RND_BLOOM_FILTER_COUNTING) {
+        for (size_t i = 0; i < COUNT; i += 2) {
+            RND_bloomFilterRemove(filter, keys[i]);
+        }
+        positives = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            positives += RND_bloomFilterContains(filter, others[i]);
+        }
+        for (size_t i = 1; i < COUNT; i += 2) {
+            if (!RND_bloomFilterContains(filter, keys[i])) {
+                printf("%s: false negative for %s after removal\n", name, keys[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        printf("%-8s | %8.2f | %9s | %9s | %10.3f | %12.3f\n", "removed", (double)bits / COUNT,
+                "-", "-", 100.0 * positives / COUNT, 100 * RND_bloomFilterRate(filter));
+    }
+    RND_bloomFilterDestroy(filter);
+}
+
+void runHashMap()
+{
+    size_t size;
+    unsigned int hashes;
+    RND_bloomFilterSuggest(COUNT, RATE, &size, &hashes);
+    RND_BloomFilter *filter = RND_bloomFilterCreate(size, hashes, RND_BLOOM_FILTER_BLOCKED, NULL);
+    RND_HashMap *map = RND_hashMapCreate(COUNT, NULL);
+    for (size_t i = 0; i < COUNT; i++) {
+        RND_hashMapAdd(map, keys[i], keys[i]);
+        RND_bloomFilterAdd(filter, keys[i]);
+    }
+    size_t found = 0;
+    freopen("/dev/null", "w", stderr);
+    double start = RND_getWallTime_usec();
+    for (size_t i = 0; i < COUNT; i++) {
+        found += RND_hashMapGet(map, others[i]) != NULL;
+    }
+    double mid = RND_getWallTime_usec();
+    for (size_t i = 0; i < COUNT; i++) {
+        found += RND_bloomFilterContains(filter, others[i]) && RND_hashMapGet(map, others[i]) != NULL;
+    }
+    double end = RND_getWallTime_usec();
+    if (found) {
+        printf("hashmap: found a key that was not added\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("\nMISSING KEYS | GET (ns/op) | FILTER + GET (ns/op)\n");
+    printf("%12d | %11.2f | %20.2f\n", COUNT, (mid - start) * 1000 / COUNT, (end - mid) * 1000 / COUNT);
+    RND_hashMapDestroy(map, NULL);
+    RND_bloomFilterDestroy(filter);
+}
+
+int main(int argc, char **argv)
+{
+    for (size_t i = 0; i < COUNT; i++) {
+        sprintf(keys[i], "user%lu", (unsigned long)i);
+        sprintf(others[i], "guest%lu", (unsigned long)i);
+    }
+    printf("%d keys, target false positive rate %.1f%%\n", COUNT, 100 * RATE);
+    printf("FILTER   | BITS/KEY |  ADD (ns) | FIND (ns) | MEASURED %% | ESTIMATED %%\n");
+    run("plain", RND_BLOOM_FILTER_PLAIN);
+    run("blocked", RND_BLOOM_FILTER_BLOCKED);
+    run("counting", RND_BLOOM_FILTER_COUNTING);
+    runHashMap();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include <RND_BloomFilter.h>
+
+int main(int argc, char **argv)
+{
+    // Room for 1000 keys with about 1% false positives
+    size_t size;
+    unsigned int hashes;
+    RND_bloomFilterSuggest(1000, 0.01, &size, &hashes);
+    printf("%lu bits, %u hashes\n", (unsigned long)size, hashes);
+
+    RND_BloomFilter *seen = RND_bloomFilterCreate(size, hashes, RND_BLOOM_FILTER_BLOCKED, NULL);
+    RND_bloomFilterAdd(seen, "apple");
+    RND_bloomFilterAdd(seen, "banana");
+    printf("apple: %d, banana: %d, cherry: %d\n", RND_bloomFilterContains(seen, "apple"),
+            RND_bloomFilterContains(seen, "banana"), RND_bloomFilterContains(seen, "cherry"));
+    printf("estimated false positive rate: %g\n", RND_bloomFilterRate(seen));
+    RND_bloomFilterDestroy(seen);
+
+    // Only counting filters can forget keys
+    RND_BloomFilter *cart = RND_bloomFilterCreate(size, hashes, RND_BLOOM_FILTER_COUNTING, NULL);
+    RND_bloomFilterAdd(cart, "apple");
+    RND_bloomFilterAdd(cart, "banana");
+    RND_bloomFilterRemove(cart, "apple");
+    printf("apple: %d, banana: %d\n", RND_bloomFilterContains(cart, "apple"), RND_bloomFilterContains(cart, "banana"));
+    RND_bloomFilterClear(cart);
+    printf("after clearing, banana: %d\n", RND_bloomFilterContains(cart, "banana"));
+    RND_bloomFilterDestroy(cart);
+
+    return EXIT_SUCCESS;
+}
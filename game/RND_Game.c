@@ -299,6 +299,43 @@ int RND_gameHandlerListDtor(const void *handler)
     return 0;
 }
 
+// A sorted array of instance ids, used to remove many instances from a handler queue at once
+typedef struct RND_GameIdSet
+{
+    RND_GameInstanceId *ids;
+    size_t size, capacity;
+} RND_GameIdSet;
+
+static int RND_gameIdCompare(const void *a, const void *b)
+{
+    RND_GameInstanceId x = *(const RND_GameInstanceId*)a,
+                       y = *(const RND_GameInstanceId*)b;
+    return (x > y) - (x < y);
+}
+
+static bool RND_gameIdSetContains(const void *value, int priority, void *set)
+{
+    (void)priority;
+    RND_GameIdSet *s = (RND_GameIdSet*)set;
+    return bsearch(value, s->ids, s->size, sizeof(RND_GameInstanceId), RND_gameIdCompare) != NULL;
+}
+
+// Removes all instances collected in set from the handler's queue in one pass
+static int RND_gameHandlerFlushRemovals(RND_GameHandler *handler, RND_GameIdSet *set)
+{
+    if (!set->size) {
+        return 0;
+    }
+    qsort(set->ids, set->size, sizeof(RND_GameInstanceId), RND_gameIdCompare);
+    int error;
+    if ((error = RND_priorityQueueRemoveIf(handler->queue, RND_gameIdSetContains, set, RND_priorityQueueDtorFree))) {
+        RND_ERROR("RND_priorityQueueRemoveIf returned %d for %lu instances", error, set->size);
+        return error;
+    }
+    set->size = 0;
+    return 0;
+}
+
 int RND_gameHandlerUpdateQueue(RND_GameHandler *handler)
 {
     if (!handler) {
@@ -307,43 +344,66 @@ int RND_gameHandlerUpdateQueue(RND_GameHandler *handler)
     }
     RND_Queue *q = handler->queue_pending_changes;
     RND_PriorityQueue *pq = handler->queue;
+    /* Removals are collected and applied together, right before
+     * the next insertion (which may re-add a removed instance)
+     * or once all operations have been read.
+     */
+    RND_GameIdSet removed = { NULL, 0, 0 };
+    int ret = 0;
     while (q->size > 0) {
         RND_GameHandlerOp *hop = *q->head;
         if (hop == NULL) {
             RND_ERROR("failed to retrieve next operation");
-            return 2;
+            ret = 2;
+            break;
         }
         RND_GameInstanceId id = hop->id;
         if (hop->opcode == 0) {
-            size_t index = 0;
-            for (RND_PriorityQueuePair *i = pq->head; i; i = (i == pq->data + pq->capacity - 1)? pq->data : i + 1, index++) {
-                if (id == *(RND_GameInstanceId*)(i->value)) {
-                    int error;
-                    if ((error = RND_priorityQueueRemove(pq, index, RND_priorityQueueDtorFree))) {
-                        RND_ERROR("RND_priorityQueueRemove returned %d for instance id %lu (%s), index %lu",
-                                error, id, RND_gameObjectGetName(RND_instances[id].index), index);
-                        return 3;
-                    }
+            if (removed.size == removed.capacity) {
+                size_t newcap = removed.capacity? removed.capacity * 2 : 16;
+                RND_GameInstanceId *new;
+                if (!(new = realloc(removed.ids, sizeof(RND_GameInstanceId) * newcap))) {
+                    RND_ERROR("realloc");
+                    ret = 5;
                     break;
                 }
+                removed.ids = new;
+                removed.capacity = newcap;
             }
+            removed.ids[removed.size++] = id;
         } else {
+            if (RND_gameHandlerFlushRemovals(handler, &removed)) {
+                RND_ERROR("failed to remove instances from the queue");
+                ret = 3;
+                break;
+            }
             int priority;
             priority = (handler->priority_func)? handler->priority_func(RND_instances + id) : 0;
             RND_GameInstanceId *new_id;
             if (!(new_id = malloc(sizeof(RND_GameInstanceId)))) {
                 RND_ERROR("malloc");
-                return 5;
+                ret = 5;
+                break;
             }
             *new_id = id;
             int err;
             if ((err = RND_priorityQueuePush(pq, new_id, priority))) {
                 RND_ERROR("RND_priorityQueuePush returned %d for instance %lu (%s)",
                         err, id, RND_gameObjectGetName(RND_instances[id].index));
-                return 4;
+                free(new_id);
+                ret = 4;
+                break;
             }
         }
         RND_queuePop(q, RND_queueDtorFree);
     }
-    return 0;
+    // The operations of the collected removals are already popped, so apply them even after an error
+    if (RND_gameHandlerFlushRemovals(handler, &removed)) {
+        RND_ERROR("failed to remove instances from the queue");
+        if (!ret) {
+            ret = 3;
+        }
+    }
+    free(removed.ids);
+    return ret;
 }
@@ -459,13 +459,18 @@ inline void RND_gameHandlerAdd(const RND_GameHandler *handler, RND_GameObjectInd
  * This is a strictly internal library function, do not mess
  * with it or you may cause undefined behavior to happen.
  *
+ * Consecutive deletions are applied together with a single
+ * @c RND_priorityQueueRemoveIf pass over the queue, so killing
+ * many instances in one frame costs O(n) rather than O(n) each.
+ *
  * @param[inout] handler The event handler to operate on.
  * @return
  * - 0 - success
  * - 1 - @p handler is a NULL pointer
  * - 2 - @c RND_queuePeek returned @c NULL (failed to retrieve next operation)
- * - 3 - @c RND_priorityQueueRemove returned error
+ * - 3 - @c RND_priorityQueueRemoveIf returned error
  * - 4 - @c RND_priorityQueuePush returned error
+ * - 5 - insufficient memory
  */
 int RND_gameHandlerUpdateQueue(RND_GameHandler *handler);
 
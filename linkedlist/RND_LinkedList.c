@@ -255,3 +255,109 @@ int RND_linkedListCopy(RND_LinkedList **dest, RND_LinkedList **src, void* (*cpy)
     }
     return 0;
 }
+
+int RND_linkedListIntrusiveInit(RND_LinkedListIntrusive *list)
+{
+    if (!list) {
+        RND_ERROR("the list does not exist");
+        return 1;
+    }
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return 0;
+}
+
+int RND_linkedListIntrusiveAdd(RND_LinkedListIntrusive *list, RND_LinkedListLink *link)
+{
+    return RND_linkedListIntrusiveInsertAfter(list, list? list->tail : NULL, link);
+}
+
+int RND_linkedListIntrusiveInsertAfter(RND_LinkedListIntrusive *list, RND_LinkedListLink *pos, RND_LinkedListLink *link)
+{
+    if (!list || !link) {
+        RND_ERROR("the list or link does not exist");
+        return 1;
+    }
+    link->prev = pos;
+    link->next = pos? pos->next : list->head;
+    if (link->next) {
+        link->next->prev = link;
+    } else {
+        list->tail = link;
+    }
+    if (pos) {
+        pos->next = link;
+    } else {
+        list->head = link;
+    }
+    list->size++;
+    return 0;
+}
+
+int RND_linkedListIntrusiveRemove(RND_LinkedListIntrusive *list, RND_LinkedListLink *link)
+{
+    if (!list || !link) {
+        RND_ERROR("the list or link does not exist");
+        return 1;
+    }
+    if (link->prev) {
+        link->prev->next = link->next;
+    } else {
+        list->head = link->next;
+    }
+    if (link->next) {
+        link->next->prev = link->prev;
+    } else {
+        list->tail = link->prev;
+    }
+    link->prev = link->next = NULL;
+    list->size--;
+    return 0;
+}
+
+RND_LinkedListLink *RND_linkedListIntrusiveGet(const RND_LinkedListIntrusive *list, size_t index)
+{
+    if (!list) {
+        RND_ERROR("the list does not exist");
+        return NULL;
+    }
+    if (index >= list->size) {
+        RND_ERROR("index %lu out of bounds (size %lu)", index, list->size);
+        return NULL;
+    }
+    RND_LinkedListLink *ret;
+    if (index < list->size / 2) {
+        for (ret = list->head; index--; ret = ret->next);
+    } else {
+        for (ret = list->tail, index = list->size - 1 - index; index--; ret = ret->prev);
+    }
+    return ret;
+}
+
+size_t RND_linkedListIntrusiveSize(const RND_LinkedListIntrusive *list)
+{
+    if (!list) {
+        RND_ERROR("the list does not exist");
+        return 0;
+    }
+    return list->size;
+}
+
+int RND_linkedListIntrusiveMap(RND_LinkedListIntrusive *list, int (*map)(RND_LinkedListLink*, size_t))
+{
+    if (!list || !list->head || !map) {
+        RND_WARN("list or map function empty");
+        return 1;
+    }
+    size_t p = 0;
+    for (RND_LinkedListLink *q = list->head, *next; q; q = next, p++) {
+        next = q->next;
+        int error;
+        if ((error = map(q, p))) {
+            RND_ERROR("map function returned %d for element no. %lu (%p)", error, p, (void*)q);
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -8,14 +8,31 @@
 #define RND_LINKEDLIST_H
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdbool.h>
 
+/********************************************************
+ *                        MACROS                        *
+ ********************************************************/
+
+/** Returns the address of the struct an intrusive link is embedded in.
+ *
+ * @param[in] link A pointer to a @ref RND_LinkedListLink.
+ * @param[in] type The type of the struct which contains the link.
+ * @param[in] member The name of the link field inside @p type.
+ */
+#define RND_LINKEDLIST_ENTRY(link, type, member) \
+    ((type*)((char*)(link) - offsetof(type, member)))
+
+
 /********************************************************
  *                      STRUCTURES                      *
  ********************************************************/
 
 /// @cond
 typedef struct RND_LinkedList RND_LinkedList;
+typedef struct RND_LinkedListLink RND_LinkedListLink;
+typedef struct RND_LinkedListIntrusive RND_LinkedListIntrusive;
 /// @endcond
 
 /// A classic linked list structure for arbitrary data.
@@ -27,6 +44,44 @@ struct RND_LinkedList
     RND_LinkedList *next;
 };
 
+/** A link field to be embedded in user structs.
+ *
+ * Unlike @ref RND_LinkedList, which allocates a separate
+ * element for every stored pointer, an intrusive list is
+ * threaded directly through its elements. To make a struct
+ * storable in a @ref RND_LinkedListIntrusive, give it a
+ * member of this type and pass that member's address to
+ * the list functions. Use @ref RND_LINKEDLIST_ENTRY to get
+ * back from a link to the struct containing it.
+ *
+ * A link can only belong to one list at a time.
+ */
+struct RND_LinkedListLink
+{
+    /// The previous link in the list (@c NULL for the first one).
+    RND_LinkedListLink *prev;
+    /// The next link in the list (@c NULL for the last one).
+    RND_LinkedListLink *next;
+};
+
+/** An intrusive doubly linked list.
+ *
+ * The list never allocates or frees any memory, so adding an
+ * already existing object costs nothing but a few pointer
+ * assignments, and an object can be removed in constant time
+ * given only its address. It is up to the user to keep the
+ * elements alive for as long as they are linked.
+ */
+struct RND_LinkedListIntrusive
+{
+    /// The first link in the list (@c NULL if empty).
+    RND_LinkedListLink *head;
+    /// The last link in the list (@c NULL if empty).
+    RND_LinkedListLink *tail;
+    /// The number of links in the list.
+    size_t size;
+};
+
 
 /********************************************************
  *                     FUNCTIONS                        *
@@ -249,4 +304,87 @@ int RND_linkedListDtorFree(const void *data);
  */
 int RND_linkedListCopy(RND_LinkedList **dest, RND_LinkedList **src, void* (*cpy)(const void*));
  
+/** Initializes an empty intrusive list.
+ *
+ * Intrusive lists do not own any memory, so there is no
+ * matching destroy function - the struct may live on the
+ * stack or inside some other struct.
+ *
+ * @param[out] list A pointer to the list to initialize.
+ * @returns
+ * - 0 - success
+ * - 1 - @p list is @c NULL
+ */
+int RND_linkedListIntrusiveInit(RND_LinkedListIntrusive *list);
+
+/** Appends a link to the end of an intrusive list.
+ *
+ * @param[inout] list A pointer to the list.
+ * @param[inout] link A pointer to a link which isn't part of any list.
+ * @returns
+ * - 0 - success
+ * - 1 - @p list or @p link is @c NULL
+ */
+int RND_linkedListIntrusiveAdd(RND_LinkedListIntrusive *list, RND_LinkedListLink *link);
+
+/** Inserts a link right after another link of an intrusive list.
+ *
+ * @param[inout] list A pointer to the list.
+ * @param[inout] pos A link already in @p list @b OR @c NULL
+ * to insert at the front of the list.
+ * @param[inout] link A pointer to a link which isn't part of any list.
+ * @returns
+ * - 0 - success
+ * - 1 - @p list or @p link is @c NULL
+ */
+int RND_linkedListIntrusiveInsertAfter(RND_LinkedListIntrusive *list, RND_LinkedListLink *pos, RND_LinkedListLink *link);
+
+/** Unlinks a link from an intrusive list in constant time.
+ *
+ * The containing struct is not freed, it simply stops being
+ * a part of the list.
+ *
+ * @param[inout] list A pointer to the list.
+ * @param[inout] link A pointer to a link which is part of @p list.
+ * @returns
+ * - 0 - success
+ * - 1 - @p list or @p link is @c NULL
+ */
+int RND_linkedListIntrusiveRemove(RND_LinkedListIntrusive *list, RND_LinkedListLink *link);
+
+/** Returns a chosen link of an intrusive list.
+ *
+ * @param[in] list A pointer to the list.
+ * @param[in] index The index of the chosen link.
+ * @returns
+ * - the chosen link - success
+ * - @c NULL - @p list is @c NULL or @p index out of bounds
+ */
+RND_LinkedListLink *RND_linkedListIntrusiveGet(const RND_LinkedListIntrusive *list, size_t index);
+
+/** Returns the number of links in an intrusive list.
+ *
+ * @param[in] list A pointer to the list.
+ * @returns
+ * - the size of the list (@ref RND_LinkedListIntrusive::size) - success
+ * - 0 - if @p list is @c NULL (or list is empty)
+ */
+size_t RND_linkedListIntrusiveSize(const RND_LinkedListIntrusive *list);
+
+/** Passes each link of an intrusive list through a custom function.
+ *
+ * Works just like @ref RND_linkedListMap. The @p map function
+ * may safely remove the link it was given from the list.
+ *
+ * @param[inout] list A pointer to the list.
+ * @param[in] map A pointer to a function which intakes
+ * a link and its index within the list. The function must
+ * return 0 for success, and any other value for failure.
+ * @returns
+ * - 0 - success
+ * - 1 - @p list is @c NULL or empty or map function is @c NULL
+ * - 2 - some @p map returned non-0 (mapping was interrupted)
+ */
+int RND_linkedListIntrusiveMap(RND_LinkedListIntrusive *list, int (*map)(RND_LinkedListLink*, size_t));
+
 #endif /* RND_LINKEDLIST_H */
@@ -20,6 +20,18 @@ bool filterOdd(RND_LinkedList *elem, size_t index)
     return index % 2;
 }
 
+typedef struct Item
+{
+    int value;
+    RND_LinkedListLink link;
+} Item;
+
+int mapPrintItem(RND_LinkedListLink *link, size_t index)
+{
+    printf("index: %2lu, value: %d\n", index, RND_LINKEDLIST_ENTRY(link, Item, link)->value);
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     RND_LinkedList *test = RND_linkedListCreate();
@@ -58,5 +70,20 @@ int main(int argc, char **argv)
     RND_linkedListDestroy(&test, RND_linkedListDtorFree);
     RND_linkedListDestroy(&copy, NULL);
 
+    // Intrusive lists thread through a link embedded in the elements
+    Item items[6];
+    RND_LinkedListIntrusive list;
+    RND_linkedListIntrusiveInit(&list);
+    for (int i = 0; i < 6; i++) {
+        items[i].value = i * 10;
+        RND_linkedListIntrusiveAdd(&list, &items[i].link);
+    }
+    RND_linkedListIntrusiveRemove(&list, &items[3].link);
+    RND_linkedListIntrusiveRemove(&list, &items[0].link);
+    RND_linkedListIntrusiveInsertAfter(&list, NULL, &items[3].link);
+    printf("\nintrusive list, 3rd element: %d\n\n",
+            RND_LINKEDLIST_ENTRY(RND_linkedListIntrusiveGet(&list, 2), Item, link)->value);
+    RND_linkedListIntrusiveMap(&list, mapPrintItem);
+
     return EXIT_SUCCESS;
 }
@@ -1,6 +1,7 @@
 #include <malloc.h>
 #include <stdio.h>
 #include <memory.h>
+#include <math.h>
 #include <RND_ErrMsg.h>
 #include "RND_PriorityQueue.h"
 
@@ -25,15 +26,215 @@ RND_PriorityQueue *RND_priorityQueueCreate(size_t capacity)
     queue->capacity = capacity;
     queue->head = queue->data;
     queue->tail = queue->data;
+    queue->heap = false;
+    queue->seq = NULL;
+    queue->next_seq = 0;
+    queue->handles = NULL;
+    queue->positions = NULL;
+    queue->free_handle = RND_PRIORITY_QUEUE_NO_HANDLE;
+    queue->next_handle = 0;
     return queue;
 }
 
+RND_PriorityQueue *RND_priorityQueueCreateHeap(size_t capacity)
+{
+    RND_PriorityQueue *queue;
+    if (!(queue = RND_priorityQueueCreate(capacity))) {
+        RND_ERROR("RND_priorityQueueCreate returned NULL");
+        return NULL;
+    }
+    queue->seq       = malloc(sizeof(size_t) * capacity);
+    queue->handles   = malloc(sizeof(size_t) * capacity);
+    queue->positions = malloc(sizeof(size_t) * capacity);
+    if (!queue->seq || !queue->handles || !queue->positions) {
+        RND_ERROR("malloc");
+        free(queue->seq);
+        free(queue->handles);
+        free(queue->positions);
+        free(queue->data);
+        free(queue);
+        return NULL;
+    }
+    queue->heap = true;
+    return queue;
+}
+
+/* Heap mode helpers. The heap is stored in data[0..size), the children
+ * of element i are 2i+1 and 2i+2. Instead of swapping, the sift functions
+ * carry a "hole" and only write the moving element once at the end.
+ * Every write of an element also updates its handle's position.
+ */
+typedef struct RND_PriorityQueueHeapEntry
+{
+    void *value;
+    int priority;
+    size_t seq;
+    size_t handle;
+} RND_PriorityQueueHeapEntry;
+
+static bool RND_priorityQueueHeapLess(int prio1, size_t seq1, int prio2, size_t seq2)
+{
+    return prio1 < prio2 || (prio1 == prio2 && seq1 < seq2);
+}
+
+static RND_PriorityQueueHeapEntry RND_priorityQueueHeapGet(const RND_PriorityQueue *queue, size_t index)
+{
+    RND_PriorityQueueHeapEntry entry = {
+        queue->data[index].value, queue->data[index].priority,
+        queue->seq[index], queue->handles[index]
+    };
+    return entry;
+}
+
+static void RND_priorityQueueHeapMove(RND_PriorityQueue *queue, size_t dest, size_t src)
+{
+    memcpy(queue->data + dest, queue->data + src, sizeof(RND_PriorityQueuePair));
+    queue->seq[dest] = queue->seq[src];
+    queue->handles[dest] = queue->handles[src];
+    queue->positions[queue->handles[dest]] = dest;
+}
+
+static void RND_priorityQueueHeapPlace(RND_PriorityQueue *queue, size_t index, const RND_PriorityQueueHeapEntry *entry)
+{
+    queue->data[index].value = entry->value;
+    memcpy((void*)(&queue->data[index].priority), &entry->priority, sizeof(int));
+    queue->seq[index] = entry->seq;
+    queue->handles[index] = entry->handle;
+    queue->positions[entry->handle] = index;
+}
+
+// Moves an element up from index until the heap property is restored
+static void RND_priorityQueueHeapSiftUp(RND_PriorityQueue *queue, size_t index, const RND_PriorityQueueHeapEntry *entry)
+{
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!RND_priorityQueueHeapLess(entry->priority, entry->seq, queue->data[parent].priority, queue->seq[parent])) {
+            break;
+        }
+        RND_priorityQueueHeapMove(queue, index, parent);
+        index = parent;
+    }
+    RND_priorityQueueHeapPlace(queue, index, entry);
+}
+
+// Moves an element down from index until the heap property is restored
+static void RND_priorityQueueHeapSiftDown(RND_PriorityQueue *queue, size_t index, const RND_PriorityQueueHeapEntry *entry)
+{
+    size_t child;
+    while ((child = 2 * index + 1) < queue->size) {
+        if (child + 1 < queue->size && RND_priorityQueueHeapLess(
+                    queue->data[child + 1].priority, queue->seq[child + 1],
+                    queue->data[child].priority, queue->seq[child])) {
+            child++;
+        }
+        if (!RND_priorityQueueHeapLess(queue->data[child].priority, queue->seq[child], entry->priority, entry->seq)) {
+            break;
+        }
+        RND_priorityQueueHeapMove(queue, index, child);
+        index = child;
+    }
+    RND_priorityQueueHeapPlace(queue, index, entry);
+}
+
+// Puts an element at index, sifting it whichever way is needed
+static void RND_priorityQueueHeapFix(RND_PriorityQueue *queue, size_t index, const RND_PriorityQueueHeapEntry *entry)
+{
+    if (index > 0 && RND_priorityQueueHeapLess(entry->priority, entry->seq,
+                queue->data[(index - 1) / 2].priority, queue->seq[(index - 1) / 2])) {
+        RND_priorityQueueHeapSiftUp(queue, index, entry);
+    } else {
+        RND_priorityQueueHeapSiftDown(queue, index, entry);
+    }
+}
+
+// Fills the hole at index with the last element of the heap and releases the handle
+static void RND_priorityQueueHeapRemoveAt(RND_PriorityQueue *queue, size_t index)
+{
+    size_t handle = queue->handles[index];
+    queue->positions[handle] = queue->free_handle;
+    queue->free_handle = handle;
+    queue->size--;
+    if (index != queue->size) {
+        RND_PriorityQueueHeapEntry last = RND_priorityQueueHeapGet(queue, queue->size);
+        RND_priorityQueueHeapFix(queue, index, &last);
+    }
+    queue->tail = queue->data + (queue->size? queue->size - 1 : 0);
+}
+
+// Doubles the capacity of a heap-ordered queue until it can hold "needed" elements
+static int RND_priorityQueueHeapReserve(RND_PriorityQueue *queue, size_t needed)
+{
+    if (needed <= queue->capacity) {
+        return 0;
+    }
+    size_t newcap = queue->capacity;
+    while (newcap < needed) {
+        newcap *= 2;
+    }
+    RND_PriorityQueuePair *new;
+    if (!(new = realloc(queue->data, sizeof(RND_PriorityQueuePair) * newcap))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    queue->data = new;
+    queue->head = queue->data;
+    size_t **arrays[] = { &queue->seq, &queue->handles, &queue->positions };
+    for (int i = 0; i < 3; i++) {
+        size_t *newarr;
+        if (!(newarr = realloc(*arrays[i], sizeof(size_t) * newcap))) {
+            RND_ERROR("realloc");
+            return 2;
+        }
+        *arrays[i] = newarr;
+    }
+    queue->capacity = newcap;
+    return 0;
+}
+
+// Fills in a new element's sequence number and takes a free handle for it
+static RND_PriorityQueueHeapEntry RND_priorityQueueHeapEntryNew(RND_PriorityQueue *queue, const void *data, int priority)
+{
+    RND_PriorityQueueHeapEntry entry = { (void*)data, priority, queue->next_seq++, queue->free_handle };
+    if (entry.handle == RND_PRIORITY_QUEUE_NO_HANDLE) {
+        entry.handle = queue->next_handle++;
+    } else {
+        queue->free_handle = queue->positions[entry.handle];
+    }
+    return entry;
+}
+
+static int RND_priorityQueueHeapPush(RND_PriorityQueue *queue, const void *data, int priority, size_t *handle)
+{
+    if (RND_priorityQueueHeapReserve(queue, queue->size + 1)) {
+        RND_ERROR("RND_priorityQueueHeapReserve failed");
+        return 2;
+    }
+    RND_PriorityQueueHeapEntry entry = RND_priorityQueueHeapEntryNew(queue, data, priority);
+    RND_priorityQueueHeapSiftUp(queue, queue->size++, &entry);
+    queue->tail = queue->data + queue->size - 1;
+    if (handle) {
+        *handle = entry.handle;
+    }
+    return 0;
+}
+
+// Returns true if the handle belongs to an element currently in the queue
+static bool RND_priorityQueueHeapHandleValid(const RND_PriorityQueue *queue, size_t handle)
+{
+    return handle < queue->next_handle
+        && queue->positions[handle] < queue->size
+        && queue->handles[queue->positions[handle]] == handle;
+}
+
 int RND_priorityQueuePush(RND_PriorityQueue *queue, const void *data, int priority)
 {
     if (!queue) {
         RND_ERROR("the queue does not exist");
         return 1;
     }
+    if (queue->heap) {
+        return RND_priorityQueueHeapPush(queue, data, priority, NULL);
+    }
     if (queue->size == queue->capacity) {
         queue->capacity *= 2;
         RND_PriorityQueuePair *new;
@@ -119,7 +320,9 @@ int RND_priorityQueuePop(RND_PriorityQueue *queue, int (*dtor)(const void*))
         RND_ERROR("dtor returned %d for data %p", error, queue->head->value);
         return 2;
     }
-    if (queue->size > 0) {
+    if (queue->heap && queue->size > 0) {
+        RND_priorityQueueHeapRemoveAt(queue, 0);
+    } else if (queue->size > 0) {
         if (--queue->size == 0) {
             queue->head = queue->tail;
         } else {
@@ -131,6 +334,37 @@ int RND_priorityQueuePop(RND_PriorityQueue *queue, int (*dtor)(const void*))
     return 0;
 }
 
+size_t RND_priorityQueuePopUntil(RND_PriorityQueue *queue, int max_priority, void **out, size_t max_count)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 0;
+    }
+    size_t count = 0;
+    if (queue->heap) {
+        while (count < max_count && queue->size && queue->data[0].priority <= max_priority) {
+            if (out) {
+                out[count] = queue->data[0].value;
+            }
+            RND_priorityQueueHeapRemoveAt(queue, 0);
+            count++;
+        }
+        return count;
+    }
+    RND_PriorityQueuePair *edge = queue->data + queue->capacity - 1,
+                          *elem = queue->head;
+    while (count < max_count && count < queue->size && elem->priority <= max_priority) {
+        if (out) {
+            out[count] = elem->value;
+        }
+        elem = (elem == edge)? queue->data : elem + 1;
+        count++;
+    }
+    queue->size -= count;
+    queue->head = queue->size? elem : queue->tail;
+    return count;
+}
+
 int RND_priorityQueueRemove(RND_PriorityQueue *queue, size_t index, int (*dtor)(const void *))
 {
     if (!queue) {
@@ -142,6 +376,14 @@ int RND_priorityQueueRemove(RND_PriorityQueue *queue, size_t index, int (*dtor)(
         return 3;
     }
     int error;
+    if (queue->heap) {
+        if (dtor && (error = dtor(queue->data[index].value))) {
+            RND_ERROR("dtor returned %d for data %p", error, queue->data[index].value);
+            return 2;
+        }
+        RND_priorityQueueHeapRemoveAt(queue, index);
+        return 0;
+    }
     RND_PriorityQueuePair *elem = queue->head,
                           *src;
     for (int i = 0; i < index; i++) {
@@ -166,12 +408,115 @@ int RND_priorityQueueRemove(RND_PriorityQueue *queue, size_t index, int (*dtor)(
     return 0;
 }
 
+/* Removes every element for which either pred returns true or marked[index]
+ * is set, moving the kept elements down over the gaps in a single pass.
+ */
+static int RND_priorityQueueCompact(RND_PriorityQueue *queue, bool (*pred)(const void*, int, void*), void *arg, const bool *marked, int (*dtor)(const void*))
+{
+    int ret = 0;
+    size_t kept = 0;
+    if (queue->heap) {
+        for (size_t i = 0; i < queue->size; i++) {
+            RND_PriorityQueuePair *elem = queue->data + i;
+            bool remove = marked? marked[i] : pred(elem->value, elem->priority, arg);
+            int error;
+            if (remove && dtor && (error = dtor(elem->value))) {
+                RND_ERROR("dtor returned %d for data %p", error, elem->value);
+                ret = 2;
+                remove = false;
+            }
+            if (remove) {
+                queue->positions[queue->handles[i]] = queue->free_handle;
+                queue->free_handle = queue->handles[i];
+            } else {
+                if (kept != i) {
+                    RND_priorityQueueHeapMove(queue, kept, i);
+                }
+                kept++;
+            }
+        }
+        queue->size = kept;
+        for (size_t i = kept / 2; i-- > 0;) {
+            RND_PriorityQueueHeapEntry entry = RND_priorityQueueHeapGet(queue, i);
+            RND_priorityQueueHeapSiftDown(queue, i, &entry);
+        }
+        queue->tail = queue->data + (kept? kept - 1 : 0);
+        return ret;
+    }
+    RND_PriorityQueuePair *edge = queue->data + queue->capacity - 1,
+                          *src  = queue->head,
+                          *dest = queue->head;
+    for (size_t i = 0; i < queue->size; i++) {
+        bool remove = marked? marked[i] : pred(src->value, src->priority, arg);
+        int error;
+        if (remove && dtor && (error = dtor(src->value))) {
+            RND_ERROR("dtor returned %d for data %p", error, src->value);
+            ret = 2;
+            remove = false;
+        }
+        if (!remove) {
+            if (dest != src) {
+                dest->value = src->value;
+                memcpy((void*)(&dest->priority), &src->priority, sizeof(int));
+            }
+            dest = (dest == edge)? queue->data : dest + 1;
+            kept++;
+        }
+        src = (src == edge)? queue->data : src + 1;
+    }
+    queue->size = kept;
+    if (kept) {
+        queue->tail = (dest == queue->data)? edge : dest - 1;
+    } else {
+        queue->tail = queue->head;
+    }
+    return ret;
+}
+
+int RND_priorityQueueRemoveIf(RND_PriorityQueue *queue, bool (*pred)(const void*, int, void*), void *arg, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!pred) {
+        RND_ERROR("the predicate does not exist");
+        return 1;
+    }
+    return RND_priorityQueueCompact(queue, pred, arg, NULL, dtor);
+}
+
+int RND_priorityQueueRemoveMarked(RND_PriorityQueue *queue, const bool *marked, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!marked) {
+        RND_ERROR("the marked array does not exist");
+        return 1;
+    }
+    return RND_priorityQueueCompact(queue, NULL, NULL, marked, dtor);
+}
+
 int RND_priorityQueueClear(RND_PriorityQueue *queue, int (*dtor)(const void*))
 {
     if (!queue) {
         RND_ERROR("the queue does not exist");
         return 1;
     }
+    if (queue->heap) {
+        // Removing leaves from the back never breaks the heap property
+        while (queue->size) {
+            int error;
+            if (dtor && (error = dtor(queue->data[queue->size - 1].value))) {
+                RND_ERROR("dtor returned %d for data %p", error, queue->data[queue->size - 1].value);
+                return 2;
+            }
+            RND_priorityQueueHeapRemoveAt(queue, queue->size - 1);
+        }
+        return 0;
+    }
     if (dtor) {
         while (queue->size) {
             int error;
@@ -201,6 +546,9 @@ int RND_priorityQueueDestroy(RND_PriorityQueue *queue, int (*dtor)(const void*))
         return error;
     }
     free(queue->data);
+    free(queue->seq);
+    free(queue->handles);
+    free(queue->positions);
     free(queue);
     return 0;
 }
@@ -254,10 +602,28 @@ int RND_priorityQueueCopy(RND_PriorityQueue *dest, const RND_PriorityQueue *src,
     }
     dest->size = src->size;
     dest->capacity = src->capacity;
+    dest->heap = src->heap;
+    dest->next_seq = src->next_seq;
+    dest->free_handle = src->free_handle;
+    dest->next_handle = src->next_handle;
+    dest->seq = NULL;
+    dest->handles = NULL;
+    dest->positions = NULL;
     if (!(dest->data = calloc(src->capacity, sizeof(RND_PriorityQueuePair)))) {
         RND_ERROR("calloc");
         return 1;
     }
+    if (src->heap) {
+        if (!(dest->seq = malloc(sizeof(size_t) * src->capacity))
+                || !(dest->handles = malloc(sizeof(size_t) * src->capacity))
+                || !(dest->positions = malloc(sizeof(size_t) * src->capacity))) {
+            RND_ERROR("malloc");
+            return 1;
+        }
+        memcpy(dest->seq, src->seq, sizeof(size_t) * src->size);
+        memcpy(dest->handles, src->handles, sizeof(size_t) * src->size);
+        memcpy(dest->positions, src->positions, sizeof(size_t) * src->next_handle);
+    }
     for (RND_PriorityQueuePair *s = src->data, *d = dest->data; s < src->data + src->capacity; s++, d++) {
         if (cpy != NULL) {
             void *new;
@@ -275,3 +641,759 @@ int RND_priorityQueueCopy(RND_PriorityQueue *dest, const RND_PriorityQueue *src,
     dest->tail = dest->data + (src->tail - src->data);
     return 0;
 }
+
+int RND_priorityQueuePushHandle(RND_PriorityQueue *queue, const void *data, int priority, RND_PriorityQueueHandle *handle)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!queue->heap) {
+        RND_ERROR("handles are only supported by heap-ordered queues");
+        return 3;
+    }
+    return RND_priorityQueueHeapPush(queue, data, priority, handle);
+}
+
+int RND_priorityQueueUpdate(RND_PriorityQueue *queue, RND_PriorityQueueHandle handle, int priority)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!queue->heap) {
+        RND_ERROR("handles are only supported by heap-ordered queues");
+        return 3;
+    }
+    if (!RND_priorityQueueHeapHandleValid(queue, handle)) {
+        RND_ERROR("handle %lu does not belong to any element", handle);
+        return 4;
+    }
+    size_t index = queue->positions[handle];
+    RND_PriorityQueueHeapEntry entry = RND_priorityQueueHeapGet(queue, index);
+    entry.priority = priority;
+    RND_priorityQueueHeapFix(queue, index, &entry);
+    return 0;
+}
+
+int RND_priorityQueueRemoveHandle(RND_PriorityQueue *queue, RND_PriorityQueueHandle handle, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!queue->heap) {
+        RND_ERROR("handles are only supported by heap-ordered queues");
+        return 3;
+    }
+    if (!RND_priorityQueueHeapHandleValid(queue, handle)) {
+        RND_ERROR("handle %lu does not belong to any element", handle);
+        return 4;
+    }
+    size_t index = queue->positions[handle];
+    int error;
+    if (dtor && (error = dtor(queue->data[index].value))) {
+        RND_ERROR("dtor returned %d for data %p", error, queue->data[index].value);
+        return 2;
+    }
+    RND_priorityQueueHeapRemoveAt(queue, index);
+    return 0;
+}
+
+// A mutable copy of a pair, used for sorting batches
+typedef struct RND_PriorityQueueBatchEntry
+{
+    void *value;
+    int priority;
+    size_t index;
+} RND_PriorityQueueBatchEntry;
+
+// Orders batch entries by priority, keeping their original order among equal ones
+static int RND_priorityQueueBatchCompare(const void *a, const void *b)
+{
+    const RND_PriorityQueueBatchEntry *x = a, *y = b;
+    if (x->priority != y->priority) {
+        return (x->priority < y->priority)? -1 : 1;
+    }
+    return (x->index < y->index)? -1 : (x->index > y->index);
+}
+
+static int RND_priorityQueueHeapPushBatch(RND_PriorityQueue *queue, const RND_PriorityQueuePair *pairs, size_t count)
+{
+    if (RND_priorityQueueHeapReserve(queue, queue->size + count)) {
+        RND_ERROR("RND_priorityQueueHeapReserve failed");
+        return 2;
+    }
+    size_t old_size = queue->size;
+    if (count < old_size) {
+        // Sifting each new element up is cheaper than rebuilding a large heap
+        for (size_t i = 0; i < count; i++) {
+            RND_PriorityQueueHeapEntry entry = RND_priorityQueueHeapEntryNew(queue, pairs[i].value, pairs[i].priority);
+            RND_priorityQueueHeapSiftUp(queue, queue->size++, &entry);
+        }
+    } else {
+        // Append everything, then restore the heap property bottom-up in O(n)
+        for (size_t i = 0; i < count; i++) {
+            RND_PriorityQueueHeapEntry entry = RND_priorityQueueHeapEntryNew(queue, pairs[i].value, pairs[i].priority);
+            RND_priorityQueueHeapPlace(queue, queue->size++, &entry);
+        }
+        for (size_t i = queue->size / 2; i-- > 0;) {
+            RND_PriorityQueueHeapEntry entry = RND_priorityQueueHeapGet(queue, i);
+            RND_priorityQueueHeapSiftDown(queue, i, &entry);
+        }
+    }
+    queue->tail = queue->data + queue->size - 1;
+    return 0;
+}
+
+static int RND_priorityQueueSortedPushBatch(RND_PriorityQueue *queue, const RND_PriorityQueuePair *pairs, size_t count)
+{
+    RND_PriorityQueueBatchEntry *batch;
+    if (!(batch = malloc(sizeof(RND_PriorityQueueBatchEntry) * count))) {
+        RND_ERROR("malloc");
+        return 2;
+    }
+    for (size_t i = 0; i < count; i++) {
+        batch[i].value = pairs[i].value;
+        batch[i].priority = pairs[i].priority;
+        batch[i].index = i;
+    }
+    qsort(batch, count, sizeof(RND_PriorityQueueBatchEntry), RND_priorityQueueBatchCompare);
+
+    size_t newcap = queue->capacity;
+    while (newcap < queue->size + count) {
+        newcap *= 2;
+    }
+    RND_PriorityQueuePair *new;
+    if (!(new = malloc(sizeof(RND_PriorityQueuePair) * newcap))) {
+        RND_ERROR("malloc");
+        free(batch);
+        return 2;
+    }
+    // Merge the queue with the batch, queued elements win ties to keep FIFO order
+    size_t i = 0, j = 0, k = 0;
+    const RND_PriorityQueuePair *elem = queue->head;
+    while (i < queue->size || j < count) {
+        if (j == count || (i < queue->size && elem->priority <= batch[j].priority)) {
+            new[k].value = elem->value;
+            memcpy((void*)(&new[k].priority), &elem->priority, sizeof(int));
+            elem = (elem == queue->data + queue->capacity - 1)? queue->data : elem + 1;
+            i++;
+        } else {
+            new[k].value = batch[j].value;
+            memcpy((void*)(&new[k].priority), &batch[j].priority, sizeof(int));
+            j++;
+        }
+        k++;
+    }
+    free(batch);
+    free(queue->data);
+    queue->data = new;
+    queue->capacity = newcap;
+    queue->size = k;
+    queue->head = queue->data;
+    queue->tail = queue->data + queue->size - 1;
+    return 0;
+}
+
+int RND_priorityQueuePushBatch(RND_PriorityQueue *queue, const RND_PriorityQueuePair *pairs, size_t count)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!count) {
+        return 0;
+    }
+    if (!pairs) {
+        RND_ERROR("the pairs array does not exist");
+        return 1;
+    }
+    return queue->heap? RND_priorityQueueHeapPushBatch(queue, pairs, count)
+                      : RND_priorityQueueSortedPushBatch(queue, pairs, count);
+}
+
+RND_PriorityQueue *RND_priorityQueueFromArray(const RND_PriorityQueuePair *pairs, size_t count, bool heap)
+{
+    RND_PriorityQueue *queue;
+    size_t capacity = count? count : 1;
+    if (!(queue = heap? RND_priorityQueueCreateHeap(capacity) : RND_priorityQueueCreate(capacity))) {
+        RND_ERROR("failed to create the queue");
+        return NULL;
+    }
+    int error;
+    if ((error = RND_priorityQueuePushBatch(queue, pairs, count))) {
+        RND_ERROR("RND_priorityQueuePushBatch returned error %d", error);
+        RND_priorityQueueDestroy(queue, NULL);
+        return NULL;
+    }
+    return queue;
+}
+
+/* Concurrent queue helpers. Each thread keeps its own random number
+ * generator (xorshift), so that picking shards needs no shared state.
+ */
+static __thread uint32_t RND_priorityQueueMultiSeed;
+
+static size_t RND_priorityQueueMultiRandom(size_t bound)
+{
+    uint32_t x = RND_priorityQueueMultiSeed;
+    if (!x) {
+        // Seed from a per-thread address, which differs between threads
+        x = (uint32_t)(uintptr_t)&RND_priorityQueueMultiSeed | 1;
+    }
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    RND_priorityQueueMultiSeed = x;
+    return x % bound;
+}
+
+static bool RND_priorityQueueMultiTryLock(RND_PriorityQueueMultiShard *shard)
+{
+    return !__atomic_load_n(&shard->lock, __ATOMIC_RELAXED)
+        && !__atomic_exchange_n(&shard->lock, 1, __ATOMIC_ACQUIRE);
+}
+
+static void RND_priorityQueueMultiLock(RND_PriorityQueueMultiShard *shard)
+{
+    while (!RND_priorityQueueMultiTryLock(shard));
+}
+
+// Publishes the shard's size and front priority, then releases its lock
+static void RND_priorityQueueMultiUnlock(RND_PriorityQueueMultiShard *shard)
+{
+    if (shard->queue->size) {
+        __atomic_store_n(&shard->top, shard->queue->data[0].priority, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&shard->size, shard->queue->size, __ATOMIC_RELAXED);
+    __atomic_store_n(&shard->lock, 0, __ATOMIC_RELEASE);
+}
+
+// Removes the front element of a locked, non-empty shard
+static void *RND_priorityQueueMultiShardTake(RND_PriorityQueueMulti *queue, RND_PriorityQueueMultiShard *shard, int *priority)
+{
+    void *data = shard->queue->data[0].value;
+    if (priority) {
+        *priority = shard->queue->data[0].priority;
+    }
+    RND_priorityQueueHeapRemoveAt(shard->queue, 0);
+    __atomic_sub_fetch(&queue->size, 1, __ATOMIC_RELAXED);
+    return data;
+}
+
+RND_PriorityQueueMulti *RND_priorityQueueMultiCreate(size_t shard_count)
+{
+    if (!shard_count) {
+        RND_ERROR("shard_count must be a positive value");
+        return NULL;
+    }
+    RND_PriorityQueueMulti *queue;
+    if (!(queue = malloc(sizeof(RND_PriorityQueueMulti)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    size_t align = sizeof(RND_PriorityQueueMultiShard);
+    if (!(queue->memory = malloc(sizeof(RND_PriorityQueueMultiShard) * shard_count + align - 1))) {
+        RND_ERROR("malloc");
+        free(queue);
+        return NULL;
+    }
+    queue->shards = (RND_PriorityQueueMultiShard*)(((uintptr_t)queue->memory + align - 1) / align * align);
+    queue->shard_count = shard_count;
+    queue->size = 0;
+    for (size_t i = 0; i < shard_count; i++) {
+        RND_PriorityQueueMultiShard *shard = queue->shards + i;
+        shard->lock = 0;
+        shard->top = 0;
+        shard->size = 0;
+        if (!(shard->queue = RND_priorityQueueCreateHeap(16))) {
+            RND_ERROR("RND_priorityQueueCreateHeap returned NULL");
+            while (i--) {
+                RND_priorityQueueDestroy(queue->shards[i].queue, NULL);
+            }
+            free(queue->memory);
+            free(queue);
+            return NULL;
+        }
+    }
+    return queue;
+}
+
+int RND_priorityQueueMultiPush(RND_PriorityQueueMulti *queue, const void *data, int priority)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    RND_PriorityQueueMultiShard *shard;
+    do {
+        shard = queue->shards + RND_priorityQueueMultiRandom(queue->shard_count);
+    } while (!RND_priorityQueueMultiTryLock(shard));
+    int error = RND_priorityQueueHeapPush(shard->queue, data, priority, NULL);
+    if (!error) {
+        __atomic_add_fetch(&queue->size, 1, __ATOMIC_RELAXED);
+    }
+    RND_priorityQueueMultiUnlock(shard);
+    if (error) {
+        RND_ERROR("RND_priorityQueueHeapPush returned error %d", error);
+        return error;
+    }
+    return 0;
+}
+
+void *RND_priorityQueueMultiTake(RND_PriorityQueueMulti *queue, int *priority)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return NULL;
+    }
+    // Two random choices, retried a few times if the shards are busy or empty
+    for (size_t attempt = 0; attempt < 2 * queue->shard_count + 8; attempt++) {
+        if (!__atomic_load_n(&queue->size, __ATOMIC_RELAXED)) {
+            return NULL;
+        }
+        RND_PriorityQueueMultiShard *a = queue->shards + RND_priorityQueueMultiRandom(queue->shard_count),
+                                    *b = queue->shards + RND_priorityQueueMultiRandom(queue->shard_count);
+        bool a_full = __atomic_load_n(&a->size, __ATOMIC_RELAXED) > 0,
+             b_full = __atomic_load_n(&b->size, __ATOMIC_RELAXED) > 0;
+        if (!a_full && !b_full) {
+            continue;
+        }
+        RND_PriorityQueueMultiShard *best = a;
+        if (!a_full || (b_full && __atomic_load_n(&b->top, __ATOMIC_RELAXED) < __atomic_load_n(&a->top, __ATOMIC_RELAXED))) {
+            best = b;
+        }
+        if (!RND_priorityQueueMultiTryLock(best)) {
+            continue;
+        }
+        void *data = NULL;
+        bool found = best->queue->size > 0;
+        if (found) {
+            data = RND_priorityQueueMultiShardTake(queue, best, priority);
+        }
+        RND_priorityQueueMultiUnlock(best);
+        if (found) {
+            return data;
+        }
+    }
+    // Nearly everything is empty, look through all shards in order
+    for (size_t i = 0; i < queue->shard_count; i++) {
+        RND_PriorityQueueMultiShard *shard = queue->shards + i;
+        if (!__atomic_load_n(&shard->size, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        RND_priorityQueueMultiLock(shard);
+        void *data = NULL;
+        bool found = shard->queue->size > 0;
+        if (found) {
+            data = RND_priorityQueueMultiShardTake(queue, shard, priority);
+        }
+        RND_priorityQueueMultiUnlock(shard);
+        if (found) {
+            return data;
+        }
+    }
+    return NULL;
+}
+
+int RND_priorityQueueMultiPop(RND_PriorityQueueMulti *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    void *data;
+    if (!(data = RND_priorityQueueMultiTake(queue, NULL))) {
+        RND_WARN("the queue is already empty");
+        return 1;
+    }
+    int error;
+    if (dtor && (error = dtor(data))) {
+        RND_ERROR("dtor returned %d for data %p", error, data);
+        return 2;
+    }
+    return 0;
+}
+
+int RND_priorityQueueMultiClear(RND_PriorityQueueMulti *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    for (size_t i = 0; i < queue->shard_count; i++) {
+        RND_PriorityQueueMultiShard *shard = queue->shards + i;
+        RND_priorityQueueMultiLock(shard);
+        while (shard->queue->size) {
+            void *data = shard->queue->data[shard->queue->size - 1].value;
+            int error;
+            if (dtor && (error = dtor(data))) {
+                RND_ERROR("dtor returned %d for data %p", error, data);
+                RND_priorityQueueMultiUnlock(shard);
+                return 2;
+            }
+            RND_priorityQueueHeapRemoveAt(shard->queue, shard->queue->size - 1);
+            __atomic_sub_fetch(&queue->size, 1, __ATOMIC_RELAXED);
+        }
+        RND_priorityQueueMultiUnlock(shard);
+    }
+    return 0;
+}
+
+int RND_priorityQueueMultiDestroy(RND_PriorityQueueMulti *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_priorityQueueMultiClear(queue, dtor))) {
+        RND_ERROR("RND_priorityQueueMultiClear returned error %d", error);
+        return error;
+    }
+    for (size_t i = 0; i < queue->shard_count; i++) {
+        RND_priorityQueueDestroy(queue->shards[i].queue, NULL);
+    }
+    free(queue->memory);
+    free(queue);
+    return 0;
+}
+
+size_t RND_priorityQueueMultiSize(const RND_PriorityQueueMulti *queue)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 0;
+    }
+    return __atomic_load_n(&queue->size, __ATOMIC_RELAXED);
+}
+
+/* D-ary heap helpers. Element i lives at priorities[i] and values[i],
+ * its children are arity*i+1 .. arity*i+arity. Both arrays are allocated
+ * with arity-1 extra slots in front, so that the children of any node
+ * start at a multiple of arity from the start of the allocation.
+ */
+static size_t RND_priorityQueueDaryMinChild(const int *priorities, size_t first, size_t count)
+{
+    // Find the minimum first (a plain reduction gcc can vectorize), then its position
+    int min = priorities[first];
+    for (size_t i = 1; i < count; i++) {
+        min = (priorities[first + i] < min)? priorities[first + i] : min;
+    }
+    size_t i = 0;
+    while (priorities[first + i] != min) {
+        i++;
+    }
+    return first + i;
+}
+
+static int RND_priorityQueueDaryAlloc(RND_PriorityQueueDary *queue, size_t capacity)
+{
+    size_t pad = queue->arity - 1;
+    int *priorities = queue->priorities? queue->priorities - pad : NULL;
+    void **values = queue->values? queue->values - pad : NULL;
+    if (!(priorities = realloc(priorities, sizeof(int) * (capacity + pad)))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    queue->priorities = priorities + pad;
+    if (!(values = realloc(values, sizeof(void*) * (capacity + pad)))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    queue->values = values + pad;
+    queue->capacity = capacity;
+    return 0;
+}
+
+RND_PriorityQueueDary *RND_priorityQueueDaryCreate(size_t capacity, size_t arity)
+{
+    if (!capacity) {
+        RND_ERROR("capacity must be a positive value");
+        return NULL;
+    }
+    if (arity < 2) {
+        RND_ERROR("arity must be at least 2");
+        return NULL;
+    }
+    RND_PriorityQueueDary *queue;
+    if (!(queue = malloc(sizeof(RND_PriorityQueueDary)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    queue->priorities = NULL;
+    queue->values = NULL;
+    queue->size = 0;
+    queue->arity = arity;
+    if (RND_priorityQueueDaryAlloc(queue, capacity)) {
+        RND_ERROR("RND_priorityQueueDaryAlloc failed");
+        if (queue->priorities) {
+            free(queue->priorities - (arity - 1));
+        }
+        free(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+int RND_priorityQueueDaryPush(RND_PriorityQueueDary *queue, const void *data, int priority)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (queue->size == queue->capacity && RND_priorityQueueDaryAlloc(queue, queue->capacity * 2)) {
+        RND_ERROR("RND_priorityQueueDaryAlloc failed");
+        return 2;
+    }
+    size_t index = queue->size++;
+    while (index > 0) {
+        size_t parent = (index - 1) / queue->arity;
+        if (queue->priorities[parent] <= priority) {
+            break;
+        }
+        queue->priorities[index] = queue->priorities[parent];
+        queue->values[index] = queue->values[parent];
+        index = parent;
+    }
+    queue->priorities[index] = priority;
+    queue->values[index] = (void*)data;
+    return 0;
+}
+
+void *RND_priorityQueueDaryPeek(const RND_PriorityQueueDary *queue)
+{
+    return (queue && queue->size > 0)? queue->values[0] : NULL;
+}
+
+int RND_priorityQueueDaryPop(RND_PriorityQueueDary *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (!queue->size) {
+        RND_WARN("the queue is already empty");
+        return 0;
+    }
+    int error;
+    if (dtor && (error = dtor(queue->values[0]))) {
+        RND_ERROR("dtor returned %d for data %p", error, queue->values[0]);
+        return 2;
+    }
+    size_t size = --queue->size,
+           arity = queue->arity,
+           index = 0,
+           first;
+    int priority = queue->priorities[size];
+    void *value = queue->values[size];
+    while ((first = arity * index + 1) < size) {
+        size_t count = (size - first < arity)? size - first : arity;
+        size_t child = RND_priorityQueueDaryMinChild(queue->priorities, first, count);
+        if (queue->priorities[child] >= priority) {
+            break;
+        }
+        queue->priorities[index] = queue->priorities[child];
+        queue->values[index] = queue->values[child];
+        index = child;
+    }
+    queue->priorities[index] = priority;
+    queue->values[index] = value;
+    return 0;
+}
+
+int RND_priorityQueueDaryClear(RND_PriorityQueueDary *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    // Removing from the back never breaks the heap property
+    while (queue->size) {
+        int error;
+        void *value = queue->values[queue->size - 1];
+        if (dtor && (error = dtor(value))) {
+            RND_ERROR("dtor returned %d for data %p", error, value);
+            return 2;
+        }
+        queue->size--;
+    }
+    return 0;
+}
+
+int RND_priorityQueueDaryDestroy(RND_PriorityQueueDary *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_priorityQueueDaryClear(queue, dtor))) {
+        RND_ERROR("RND_priorityQueueDaryClear returned error %d", error);
+        return error;
+    }
+    free(queue->priorities - (queue->arity - 1));
+    free(queue->values - (queue->arity - 1));
+    free(queue);
+    return 0;
+}
+
+size_t RND_priorityQueueDarySize(const RND_PriorityQueueDary *queue)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 0;
+    }
+    return queue->size;
+}
+
+/* Typed variants. Each one is a binary heap of pairs in data[0..size),
+ * generated from the same code so that priority comparisons are
+ * inlined for the concrete type. The "invalid" argument names a
+ * function-like macro telling whether a priority can't be ordered.
+ */
+#define RND_PRIORITY_QUEUE_NEVER_INVALID(priority) 0
+
+#define RND_PRIORITY_QUEUE_TYPED_LESS(a, b) \
+    ((a).priority < (b).priority || ((a).priority == (b).priority && (a).seq < (b).seq))
+
+#define RND_PRIORITY_QUEUE_DEFINE_TYPED(Name, type, invalid)                                   \
+RND_PriorityQueue##Name *RND_priorityQueue##Name##Create(size_t capacity)                      \
+{                                                                                              \
+    RND_PriorityQueue##Name *queue;                                                            \
+    if (!capacity) {                                                                           \
+        RND_ERROR("capacity must be a positive value");                                        \
+        return NULL;                                                                           \
+    }                                                                                          \
+    if (!(queue = malloc(sizeof(RND_PriorityQueue##Name)))) {                                  \
+        RND_ERROR("malloc");                                                                   \
+        return NULL;                                                                           \
+    }                                                                                          \
+    if (!(queue->data = malloc(sizeof(RND_PriorityQueue##Name##Pair) * capacity))) {           \
+        RND_ERROR("malloc");                                                                   \
+        free(queue);                                                                           \
+        return NULL;                                                                           \
+    }                                                                                          \
+    queue->size = 0;                                                                           \
+    queue->capacity = capacity;                                                                \
+    queue->next_seq = 0;                                                                       \
+    return queue;                                                                              \
+}                                                                                              \
+                                                                                               \
+int RND_priorityQueue##Name##Push(RND_PriorityQueue##Name *queue, const void *data, type priority) \
+{                                                                                              \
+    if (!queue) {                                                                              \
+        RND_ERROR("the queue does not exist");                                                 \
+        return 1;                                                                              \
+    }                                                                                          \
+    if (invalid(priority)) {                                                                   \
+        RND_ERROR("the priority cannot be compared");                                          \
+        return 3;                                                                              \
+    }                                                                                          \
+    if (queue->size == queue->capacity) {                                                      \
+        RND_PriorityQueue##Name##Pair *new;                                                    \
+        if (!(new = realloc(queue->data, sizeof(RND_PriorityQueue##Name##Pair) * queue->capacity * 2))) { \
+            RND_ERROR("realloc");                                                              \
+            return 2;                                                                          \
+        }                                                                                      \
+        queue->data = new;                                                                     \
+        queue->capacity *= 2;                                                                  \
+    }                                                                                          \
+    RND_PriorityQueue##Name##Pair entry = { (void*)data, priority, queue->next_seq++ };        \
+    size_t index = queue->size++;                                                              \
+    while (index > 0) {                                                                        \
+        size_t parent = (index - 1) / 2;                                                       \
+        if (!RND_PRIORITY_QUEUE_TYPED_LESS(entry, queue->data[parent])) {                      \
+            break;                                                                             \
+        }                                                                                      \
+        queue->data[index] = queue->data[parent];                                              \
+        index = parent;                                                                        \
+    }                                                                                          \
+    queue->data[index] = entry;                                                                \
+    return 0;                                                                                  \
+}                                                                                              \
+                                                                                               \
+void *RND_priorityQueue##Name##Peek(const RND_PriorityQueue##Name *queue)                      \
+{                                                                                              \
+    return (queue && queue->size > 0)? queue->data[0].value : NULL;                            \
+}                                                                                              \
+                                                                                               \
+int RND_priorityQueue##Name##Pop(RND_PriorityQueue##Name *queue, int (*dtor)(const void*))     \
+{                                                                                              \
+    if (!queue) {                                                                              \
+        RND_ERROR("the queue does not exist");                                                 \
+        return 1;                                                                              \
+    }                                                                                          \
+    if (!queue->size) {                                                                        \
+        RND_WARN("the queue is already empty");                                                \
+        return 0;                                                                              \
+    }                                                                                          \
+    int error;                                                                                 \
+    if (dtor && (error = dtor(queue->data[0].value))) {                                        \
+        RND_ERROR("dtor returned %d for data %p", error, queue->data[0].value);                \
+        return 2;                                                                              \
+    }                                                                                          \
+    RND_PriorityQueue##Name##Pair last = queue->data[--queue->size];                           \
+    size_t index = 0, child;                                                                   \
+    while ((child = 2 * index + 1) < queue->size) {                                            \
+        if (child + 1 < queue->size && RND_PRIORITY_QUEUE_TYPED_LESS(queue->data[child + 1], queue->data[child])) { \
+            child++;                                                                           \
+        }                                                                                      \
+        if (!RND_PRIORITY_QUEUE_TYPED_LESS(queue->data[child], last)) {                        \
+            break;                                                                             \
+        }                                                                                      \
+        queue->data[index] = queue->data[child];                                               \
+        index = child;                                                                         \
+    }                                                                                          \
+    queue->data[index] = last;                                                                 \
+    return 0;                                                                                  \
+}                                                                                              \
+                                                                                               \
+int RND_priorityQueue##Name##Clear(RND_PriorityQueue##Name *queue, int (*dtor)(const void*))   \
+{                                                                                              \
+    if (!queue) {                                                                              \
+        RND_ERROR("the queue does not exist");                                                 \
+        return 1;                                                                              \
+    }                                                                                          \
+    /* Removing from the back never breaks the heap property */                                \
+    while (queue->size) {                                                                      \
+        int error;                                                                             \
+        void *value = queue->data[queue->size - 1].value;                                      \
+        if (dtor && (error = dtor(value))) {                                                   \
+            RND_ERROR("dtor returned %d for data %p", error, value);                           \
+            return 2;                                                                          \
+        }                                                                                      \
+        queue->size--;                                                                         \
+    }                                                                                          \
+    return 0;                                                                                  \
+}                                                                                              \
+                                                                                               \
+int RND_priorityQueue##Name##Destroy(RND_PriorityQueue##Name *queue, int (*dtor)(const void*)) \
+{                                                                                              \
+    if (!queue) {                                                                              \
+        RND_ERROR("the queue does not exist");                                                 \
+        return 1;                                                                              \
+    }                                                                                          \
+    int error;                                                                                 \
+    if ((error = RND_priorityQueue##Name##Clear(queue, dtor))) {                               \
+        RND_ERROR("RND_priorityQueue" #Name "Clear returned error %d", error);                 \
+        return error;                                                                          \
+    }                                                                                          \
+    free(queue->data);                                                                         \
+    free(queue);                                                                               \
+    return 0;                                                                                  \
+}                                                                                              \
+                                                                                               \
+size_t RND_priorityQueue##Name##Size(const RND_PriorityQueue##Name *queue)                     \
+{                                                                                              \
+    if (!queue) {                                                                              \
+        RND_ERROR("the queue does not exist");                                                 \
+        return 0;                                                                              \
+    }                                                                                          \
+    return queue->size;                                                                        \
+}
+
+RND_PRIORITY_QUEUE_DEFINE_TYPED(Int64, int64_t, RND_PRIORITY_QUEUE_NEVER_INVALID)
+RND_PRIORITY_QUEUE_DEFINE_TYPED(Uint64, uint64_t, RND_PRIORITY_QUEUE_NEVER_INVALID)
+RND_PRIORITY_QUEUE_DEFINE_TYPED(Double, double, isnan)
@@ -9,6 +9,16 @@
 #define RND_PRIORITY_QUEUE_H
 
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/********************************************************
+ *                      CONSTANTS                       *
+ ********************************************************/
+
+/// A handle value which never refers to any element.
+#define RND_PRIORITY_QUEUE_NO_HANDLE ((size_t)-1)
+
 
 /********************************************************
  *                     STRUCTURES                       *
@@ -17,8 +27,20 @@
 /// @cond
 typedef struct RND_PriorityQueue RND_PriorityQueue;
 typedef struct RND_PriorityQueuePair RND_PriorityQueuePair;
+typedef struct RND_PriorityQueueMultiShard RND_PriorityQueueMultiShard;
+typedef struct RND_PriorityQueueMulti RND_PriorityQueueMulti;
+typedef struct RND_PriorityQueueDary RND_PriorityQueueDary;
 /// @endcond
 
+/** Identifies an element of a heap-ordered queue.
+ *
+ * Handles are returned by @ref RND_priorityQueuePushHandle and
+ * stay valid for as long as the element remains in the queue, no
+ * matter how it moves around. Once the element is removed, its
+ * handle may be reused for a newly pushed element.
+ */
+typedef size_t RND_PriorityQueueHandle;
+
 /** A structure for storing a value-priority pair.
  *
  * This type is used by the @ref RND_PriorityQueue
@@ -49,6 +71,20 @@ struct RND_PriorityQueuePair
  * of @ref RND_PriorityQueue, with extra steps to preserve order
  * of the elements. Most notably, the array of void pointers
  * is replaced by an array of @ref RND_PriorityQueuePair.
+ *
+ * A queue can work in one of two modes, chosen at creation:
+ * - sorted (@ref RND_priorityQueueCreate) - the elements are
+ *   kept fully sorted in a looped array, which makes iterating
+ *   over them in order trivial, but every push has to shift
+ *   the elements that come after the new one (O(n)).
+ * - heap (@ref RND_priorityQueueCreateHeap) - the elements
+ *   form an implicit binary heap starting at @ref
+ *   RND_PriorityQueue::data, which makes both push and pop
+ *   O(log n). Only the front element is guaranteed to be in
+ *   place, the rest of the array is not sorted.
+ *
+ * In both modes, elements of equal priority leave the queue
+ * in the order they were pushed.
  */
 struct RND_PriorityQueue
 {
@@ -63,6 +99,112 @@ struct RND_PriorityQueue
     /// The size of the @ref RND_PriorityQueue::data array (this
     /// number will change dynamically).
     size_t capacity;
+    /// Whether the queue is heap-ordered instead of sorted.
+    bool heap;
+    /** Insertion sequence numbers of the elements (heap mode only).
+     *
+     * A parallel array to @ref RND_PriorityQueue::data, used to
+     * break ties between elements of equal priority. It is @c NULL
+     * in sorted mode.
+     */
+    size_t *seq;
+    /// The sequence number for the next pushed element.
+    size_t next_seq;
+    /** The handle of each element (heap mode only).
+     *
+     * A parallel array to @ref RND_PriorityQueue::data.
+     */
+    RND_PriorityQueueHandle *handles;
+    /** The index of each handle's element (heap mode only).
+     *
+     * Indexed by handle. Entries of unused handles instead
+     * hold the next unused handle, forming a free list that
+     * starts at @ref RND_PriorityQueue::free_handle.
+     */
+    size_t *positions;
+    /// The first reusable handle (or @ref RND_PRIORITY_QUEUE_NO_HANDLE).
+    RND_PriorityQueueHandle free_handle;
+    /// The lowest handle that was never handed out.
+    RND_PriorityQueueHandle next_handle;
+};
+
+/** A d-ary heap with priorities and values kept in separate arrays.
+ *
+ * In @ref RND_PriorityQueue every priority is stored next to its
+ * value pointer, so comparing priorities drags the pointers into
+ * the cache as well. This heap keeps all priorities in their own
+ * contiguous @c int array, with the values in a parallel array
+ * that is only touched when elements actually move.
+ *
+ * Every node has @ref arity children instead of two, which makes
+ * the heap shallower. The children of a node are adjacent, and the
+ * array is offset so that each group of siblings starts at a
+ * multiple of @ref arity elements. Picking the smallest child is
+ * a short minimum search over one such group, which the compiler
+ * can vectorize. An arity of 4 or 8 works best for pop-heavy use.
+ *
+ * Unlike @ref RND_PriorityQueue, elements of equal priority are
+ * @b not guaranteed to leave the queue in the order they were pushed.
+ */
+struct RND_PriorityQueueDary
+{
+    /// The priorities of the elements, in heap order.
+    int *priorities;
+    /// The values of the elements, parallel to @ref priorities.
+    void **values;
+    /// The number of elements in the heap.
+    size_t size;
+    /// The number of elements that fit in the arrays.
+    size_t capacity;
+    /// The number of children of each node.
+    size_t arity;
+};
+
+/** One of the sub-queues of a @ref RND_PriorityQueueMulti.
+ *
+ * The @ref size and @ref top fields mirror the state of @ref
+ * queue, so that other threads can compare shards without taking
+ * their locks. The struct is aligned to 64 bytes, so that shards
+ * used by different threads don't share cache lines.
+ */
+struct RND_PriorityQueueMultiShard
+{
+    /// A heap-ordered queue, only accessed while holding @ref lock.
+    RND_PriorityQueue *queue;
+    /// A spinlock, 0 when free and 1 when taken.
+    int lock;
+    /// The priority of the front element (meaningless if @ref size is 0).
+    int top;
+    /// The number of elements in @ref queue.
+    size_t size;
+} __attribute__((aligned(64)));
+
+/** A thread-safe relaxed priority queue.
+ *
+ * This is a MultiQueue: the elements are spread over several
+ * heap-ordered @ref RND_PriorityQueue shards, each behind its own
+ * spinlock. A push goes to a random shard, and a pop looks at the
+ * front elements of two random shards and takes the better one.
+ * Threads rarely contend for the same lock, so throughput keeps
+ * growing with the number of threads, unlike with a single
+ * queue behind a global lock.
+ *
+ * The price is that pops are relaxed: the popped element is
+ * usually among the few lowest priorities, but not necessarily
+ * the lowest one. The queue also makes no FIFO guarantee for
+ * elements of equal priority. Use at least two shards per thread
+ * to keep contention low.
+ */
+struct RND_PriorityQueueMulti
+{
+    /// The array of shards.
+    RND_PriorityQueueMultiShard *shards;
+    /// The allocation holding @ref shards, before aligning it.
+    void *memory;
+    /// The number of elements in @ref shards.
+    size_t shard_count;
+    /// The total number of elements (updated atomically).
+    size_t size;
 };
 
 
@@ -82,6 +224,25 @@ struct RND_PriorityQueue
  */
 RND_PriorityQueue *RND_priorityQueueCreate(size_t capacity);
 
+/** Allocates a new empty heap-ordered queue and returns its pointer.
+ *
+ * The returned queue works with all the same functions as
+ * one created by @ref RND_priorityQueueCreate, but pushing
+ * and popping elements costs O(log n) instead of O(n). In
+ * exchange, the elements are not stored in sorted order,
+ * so @ref RND_priorityQueueRemove and @ref RND_priorityQueuePrint
+ * refer to the internal array order rather than priority order.
+ *
+ * @param[in] capacity The number of elements to preallocate
+ * for (cannot be 0). This number will be automatically doubled each
+ * time more space is needed due to pushing elements.
+ * @returns
+ * - the new queue's address - success
+ * - @c NULL - insufficient memory or invalid @p capacity
+ *   value
+ */
+RND_PriorityQueue *RND_priorityQueueCreateHeap(size_t capacity);
+
 /** Appends an element to the end of a queue.
  *
  * @param[inout] queue A pointer to the queue.
@@ -120,6 +281,27 @@ void *RND_priorityQueuePeek(const RND_PriorityQueue *queue);
  */
 int RND_priorityQueuePop(RND_PriorityQueue *queue, int (*dtor)(const void*));
 
+/** Removes all front elements up to a given priority at once.
+ *
+ * Removes elements from the front of a queue for as long as their
+ * priority is not greater than @p max_priority, stopping after at
+ * most @p max_count elements. The removed elements' data is stored
+ * in @p out in queue order. No dtor is called, the caller owns the
+ * returned data.
+ *
+ * In a sorted queue the elements form a contiguous prefix, so this
+ * costs O(k) for k removed elements. In a heap-ordered queue each
+ * element is still popped separately in O(log n).
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] max_priority The highest priority to remove.
+ * @param[out] out An array of at least @p max_count pointers,
+ * or @c NULL to simply discard the elements.
+ * @param[in] max_count The maximum number of elements to remove.
+ * @returns The number of removed elements (0 if @p queue is @c NULL).
+ */
+size_t RND_priorityQueuePopUntil(RND_PriorityQueue *queue, int max_priority, void **out, size_t max_count);
+
 /** Removes all elements from a queue.
  *
  * @param[inout] queue A pointer to the queue.
@@ -135,6 +317,10 @@ int RND_priorityQueuePop(RND_PriorityQueue *queue, int (*dtor)(const void*));
 int RND_priorityQueueClear(RND_PriorityQueue *queue, int (*dtor)(const void*));
 
 /** Removes an element from a queue by index.
+ *
+ * For heap-ordered queues, @p index is the position in the
+ * @ref RND_PriorityQueue::data array, which only matches the
+ * priority order for the front element (index 0).
  *
  * @param[inout] queue A pointer to the queue.
  * @param[in] index The index of the element to remove (starting at head = 0).
@@ -150,6 +336,52 @@ int RND_priorityQueueClear(RND_PriorityQueue *queue, int (*dtor)(const void*));
  */
 int RND_priorityQueueRemove(RND_PriorityQueue *queue, size_t index, int (*dtor)(const void *));
 
+/** Removes all elements matching a predicate in a single pass.
+ *
+ * The remaining elements are moved down over the removed ones as
+ * the queue is scanned, so removing any number of elements costs
+ * O(n) in a sorted queue, instead of O(n) per element with @ref
+ * RND_priorityQueueRemove. A heap-ordered queue is additionally
+ * rebuilt in O(n), and its remaining handles stay valid. In both
+ * modes, the remaining elements keep their relative order.
+ *
+ * If @p dtor fails for an element, that element is kept in the
+ * queue and the scan continues.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] pred A function which intakes an element's value and
+ * priority together with @p arg, and returns @c true if the element
+ * should be removed.
+ * @param[in] arg An arbitrary pointer passed on to @p pred.
+ * @param[in] dtor A pointer to a function which intakes
+ * a @ref RND_PriorityQueuePair::value element and frees it, returning 0
+ * for success and anything else for failure @b OR @c NULL
+ * if the data doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue or @p pred is @c NULL
+ * - 2 - @p dtor returned non-0 for some elements (they were kept)
+ */
+int RND_priorityQueueRemoveIf(RND_PriorityQueue *queue, bool (*pred)(const void*, int, void*), void *arg, int (*dtor)(const void*));
+
+/** Removes all marked elements in a single pass.
+ *
+ * Works like @ref RND_priorityQueueRemoveIf, but the elements to
+ * remove are given by an array of flags, where @c marked[i] refers
+ * to the element that @ref RND_priorityQueueRemove would remove
+ * for index @c i (the i-th element from the front in a sorted queue,
+ * the i-th element of @ref RND_PriorityQueue::data in a heap-ordered one).
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] marked An array of at least @ref RND_PriorityQueue::size flags.
+ * @param[in] dtor Same as in @ref RND_priorityQueueRemoveIf.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue or @p marked is @c NULL
+ * - 2 - @p dtor returned non-0 for some elements (they were kept)
+ */
+int RND_priorityQueueRemoveMarked(RND_PriorityQueue *queue, const bool *marked, int (*dtor)(const void*));
+
 /** Frees all memory associated with a queue.
  *
  * First frees the contents of a queue with @ref
@@ -231,4 +463,341 @@ int RND_priorityQueueDtorFree(const void *data);
  */
 int RND_priorityQueueCopy(RND_PriorityQueue *dest, const RND_PriorityQueue *src, void* (*cpy)(const void *));
 
+/** Appends an element to a heap-ordered queue and returns its handle.
+ *
+ * Works exactly like @ref RND_priorityQueuePush, except that the
+ * handle of the new element is written to @p handle, so that it
+ * can be later passed to @ref RND_priorityQueueUpdate or @ref
+ * RND_priorityQueueRemoveHandle.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] data A pointer to the data to be stored.
+ * @param[in] priority The priority of the new element.
+ * @param[out] handle Where to store the new element's handle
+ * (may be @c NULL).
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - realloc failed (insufficient memory)
+ * - 3 - @p queue is not heap-ordered
+ */
+int RND_priorityQueuePushHandle(RND_PriorityQueue *queue, const void *data, int priority, RND_PriorityQueueHandle *handle);
+
+/** Changes the priority of an element of a heap-ordered queue.
+ *
+ * The element is moved to its new place in O(log n). If other
+ * elements share the new priority, the element keeps its original
+ * position in the FIFO order among them.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] handle The handle of the element.
+ * @param[in] priority The new priority.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 3 - @p queue is not heap-ordered
+ * - 4 - @p handle does not refer to any element
+ */
+int RND_priorityQueueUpdate(RND_PriorityQueue *queue, RND_PriorityQueueHandle handle, int priority);
+
+/** Removes an element from a heap-ordered queue by handle in O(log n).
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] handle The handle of the element.
+ * @param[in] dtor A pointer to a function which intakes
+ * a @ref RND_PriorityQueuePair::value element and frees it, returning 0
+ * for success and anything else for failure @b OR @c NULL
+ * if the data doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ * - 3 - @p queue is not heap-ordered
+ * - 4 - @p handle does not refer to any element
+ */
+int RND_priorityQueueRemoveHandle(RND_PriorityQueue *queue, RND_PriorityQueueHandle handle, int (*dtor)(const void*));
+
+/** Appends many elements to a queue at once.
+ *
+ * The result is the same as pushing the elements one by one in
+ * array order, but the work is done in bulk:
+ * - in a sorted queue, the batch is sorted and then merged with
+ *   the queue in a single pass, O(n + k log k) instead of O(n * k),
+ * - in a heap-ordered queue, the batch is appended and the heap
+ *   is rebuilt bottom-up in O(n + k), unless the batch is smaller
+ *   than the queue, in which case each element is sifted up.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] pairs An array of value-priority pairs to push.
+ * @param[in] count The number of elements in @p pairs.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL, or @p pairs is @c NULL and @p count is not 0
+ * - 2 - insufficient memory (the queue is left unchanged)
+ */
+int RND_priorityQueuePushBatch(RND_PriorityQueue *queue, const RND_PriorityQueuePair *pairs, size_t count);
+
+/** Creates a new queue holding the elements of an array.
+ *
+ * The queue's capacity is set to @p count (or 1 if @p count
+ * is 0) and the elements are added with @ref
+ * RND_priorityQueuePushBatch, so building the queue is
+ * O(n log n) in sorted mode and O(n) in heap mode.
+ *
+ * @param[in] pairs An array of value-priority pairs.
+ * @param[in] count The number of elements in @p pairs.
+ * @param[in] heap Whether to create a heap-ordered queue
+ * (see @ref RND_priorityQueueCreateHeap) instead of a sorted one.
+ * @returns
+ * - the new queue's address - success
+ * - @c NULL - insufficient memory, or @p pairs is @c NULL
+ *   and @p count is not 0
+ */
+RND_PriorityQueue *RND_priorityQueueFromArray(const RND_PriorityQueuePair *pairs, size_t count, bool heap);
+
+/** Allocates a new empty concurrent queue and returns its pointer.
+ *
+ * @param[in] shard_count The number of shards (cannot be 0). Two to
+ * four times the number of threads using the queue works well.
+ * @returns
+ * - the new queue's address - success
+ * - @c NULL - insufficient memory or invalid @p shard_count value
+ */
+RND_PriorityQueueMulti *RND_priorityQueueMultiCreate(size_t shard_count);
+
+/** Inserts an element into a concurrent queue.
+ *
+ * This function is thread-safe.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] data A pointer to the data to be stored.
+ * @param[in] priority The priority of the new element.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - realloc failed (insufficient memory)
+ */
+int RND_priorityQueueMultiPush(RND_PriorityQueueMulti *queue, const void *data, int priority);
+
+/** Removes an element with a low priority from a concurrent queue and returns its data.
+ *
+ * This function is thread-safe. Unlike @ref RND_priorityQueuePeek
+ * followed by @ref RND_priorityQueuePop, it finds and removes the
+ * element in one step, so no other thread can take it in between.
+ * The element is one of the lowest priority ones, but not
+ * necessarily the lowest (see @ref RND_PriorityQueueMulti).
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[out] priority Where to store the removed element's
+ * priority (may be @c NULL).
+ * @returns
+ * - the removed element's data - success
+ * - @c NULL - the queue is empty or @p queue is @c NULL
+ */
+void *RND_priorityQueueMultiTake(RND_PriorityQueueMulti *queue, int *priority);
+
+/** Removes an element with a low priority from a concurrent queue.
+ *
+ * This is @ref RND_priorityQueueMultiTake followed by calling
+ * @p dtor on the removed data. The element is removed even if
+ * @p dtor fails.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] dtor A pointer to a function which intakes
+ * the removed data and frees it, returning 0 for success and
+ * anything else for failure @b OR @c NULL if the data doesn't
+ * need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - the queue is empty or @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_priorityQueueMultiPop(RND_PriorityQueueMulti *queue, int (*dtor)(const void*));
+
+/** Removes all elements from a concurrent queue.
+ *
+ * This function is thread-safe, but elements pushed by other
+ * threads while it runs may or may not be removed.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] dtor Same as in @ref RND_priorityQueueMultiPop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - some @p dtor returned non-0 (clearing was interrupted)
+ */
+int RND_priorityQueueMultiClear(RND_PriorityQueueMulti *queue, int (*dtor)(const void*));
+
+/** Frees all memory associated with a concurrent queue.
+ *
+ * No other thread may be using the queue at this point.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_priorityQueueMultiClear.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - some @p dtor returned non-0 (the queue is not freed)
+ */
+int RND_priorityQueueMultiDestroy(RND_PriorityQueueMulti *queue, int (*dtor)(const void*));
+
+/** Returns the number of elements in a concurrent queue.
+ *
+ * If other threads are modifying the queue, the result
+ * may already be out of date when it's returned.
+ *
+ * @param[in] queue A pointer to the queue.
+ * @returns
+ * - the size of the queue - success
+ * - 0 - if @p queue is @c NULL (or queue is empty)
+ */
+size_t RND_priorityQueueMultiSize(const RND_PriorityQueueMulti *queue);
+
+/** Allocates a new empty d-ary heap and returns its pointer.
+ *
+ * @param[in] capacity The number of elements to preallocate
+ * for (cannot be 0). This number will be automatically doubled each
+ * time more space is needed due to pushing elements.
+ * @param[in] arity The number of children of each node (at least 2).
+ * @returns
+ * - the new heap's address - success
+ * - @c NULL - insufficient memory or invalid @p capacity or
+ *   @p arity value
+ */
+RND_PriorityQueueDary *RND_priorityQueueDaryCreate(size_t capacity, size_t arity);
+
+/** Appends an element to a d-ary heap in O(log n).
+ *
+ * @param[inout] queue A pointer to the heap.
+ * @param[in] data A pointer to the data to be stored.
+ * @param[in] priority The priority of the new element.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - realloc failed (insufficient memory)
+ */
+int RND_priorityQueueDaryPush(RND_PriorityQueueDary *queue, const void *data, int priority);
+
+/** Returns the data of the front element of a d-ary heap.
+ *
+ * @param[in] queue A pointer to the heap.
+ * @returns
+ * - the front element's data - success
+ * - @c NULL - the heap is empty or @p queue is @c NULL
+ */
+void *RND_priorityQueueDaryPeek(const RND_PriorityQueueDary *queue);
+
+/** Removes the front element of a d-ary heap in O(d log n / log d).
+ *
+ * @param[inout] queue A pointer to the heap.
+ * @param[in] dtor A pointer to a function which intakes
+ * the element's data and frees it, returning 0 for success and
+ * anything else for failure @b OR @c NULL if the data doesn't
+ * need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_priorityQueueDaryPop(RND_PriorityQueueDary *queue, int (*dtor)(const void*));
+
+/** Removes all elements from a d-ary heap.
+ *
+ * @param[inout] queue A pointer to the heap.
+ * @param[in] dtor Same as in @ref RND_priorityQueueDaryPop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - some @p dtor returned non-0 (clearing was interrupted)
+ */
+int RND_priorityQueueDaryClear(RND_PriorityQueueDary *queue, int (*dtor)(const void*));
+
+/** Frees all memory associated with a d-ary heap.
+ *
+ * @param[inout] queue A pointer to the heap.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_priorityQueueDaryClear.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - some @p dtor returned non-0 (the heap is not freed)
+ */
+int RND_priorityQueueDaryDestroy(RND_PriorityQueueDary *queue, int (*dtor)(const void*));
+
+/** Returns the number of elements in a d-ary heap.
+ *
+ * @param[in] queue A pointer to the heap.
+ * @returns
+ * - the size of the heap - success
+ * - 0 - if @p queue is @c NULL (or heap is empty)
+ */
+size_t RND_priorityQueueDarySize(const RND_PriorityQueueDary *queue);
+
+
+
+/********************************************************
+ *                        MACROS                        *
+ ********************************************************/
+
+/** Declares a priority queue variant with a custom priority type.
+ *
+ * The default @ref RND_PriorityQueue only takes @c int priorities.
+ * This macro declares a separate queue type whose priorities are
+ * of type @p type, with its own set of functions. For a given
+ * @p Name, the following are declared:
+ * - @c RND_PriorityQueue<Name>Pair - a value-priority pair, which
+ *   additionally stores the insertion sequence number
+ * - @c RND_PriorityQueue<Name> - the queue itself
+ * - @c RND_priorityQueue<Name>Create(capacity)
+ * - @c RND_priorityQueue<Name>Push(queue, data, priority)
+ * - @c RND_priorityQueue<Name>Peek(queue)
+ * - @c RND_priorityQueue<Name>Pop(queue, dtor)
+ * - @c RND_priorityQueue<Name>Clear(queue, dtor)
+ * - @c RND_priorityQueue<Name>Destroy(queue, dtor)
+ * - @c RND_priorityQueue<Name>Size(queue)
+ *
+ * The functions take and return the same things as their @c int
+ * counterparts. The variants are always heap-ordered (see @ref
+ * RND_priorityQueueCreateHeap): the front element is @c data[0],
+ * so its priority can be read directly as @c data[0].priority.
+ * Elements of equal priority leave the queue in the order
+ * they were pushed. Push additionally returns 3 if the priority
+ * is not comparable (a NaN @c double).
+ *
+ * The library provides the following variants:
+ * - @c Int64 - @c int64_t priorities
+ * - @c Uint64 - @c uint64_t priorities
+ * - @c Double - @c double priorities
+ */
+#define RND_PRIORITY_QUEUE_DECLARE_TYPED(Name, type)                                           \
+    typedef struct RND_PriorityQueue##Name##Pair                                               \
+    {                                                                                          \
+        void *value;                                                                           \
+        type priority;                                                                         \
+        size_t seq;                                                                            \
+    } RND_PriorityQueue##Name##Pair;                                                           \
+                                                                                               \
+    typedef struct RND_PriorityQueue##Name                                                     \
+    {                                                                                          \
+        RND_PriorityQueue##Name##Pair *data;                                                   \
+        size_t size;                                                                           \
+        size_t capacity;                                                                       \
+        size_t next_seq;                                                                       \
+    } RND_PriorityQueue##Name;                                                                 \
+                                                                                               \
+    RND_PriorityQueue##Name *RND_priorityQueue##Name##Create(size_t capacity);                 \
+    int RND_priorityQueue##Name##Push(RND_PriorityQueue##Name *queue, const void *data, type priority); \
+    void *RND_priorityQueue##Name##Peek(const RND_PriorityQueue##Name *queue);                 \
+    int RND_priorityQueue##Name##Pop(RND_PriorityQueue##Name *queue, int (*dtor)(const void*)); \
+    int RND_priorityQueue##Name##Clear(RND_PriorityQueue##Name *queue, int (*dtor)(const void*)); \
+    int RND_priorityQueue##Name##Destroy(RND_PriorityQueue##Name *queue, int (*dtor)(const void*)); \
+    size_t RND_priorityQueue##Name##Size(const RND_PriorityQueue##Name *queue);
+
+/// @cond
+RND_PRIORITY_QUEUE_DECLARE_TYPED(Int64, int64_t)
+RND_PRIORITY_QUEUE_DECLARE_TYPED(Uint64, uint64_t)
+RND_PRIORITY_QUEUE_DECLARE_TYPED(Double, double)
+/// @endcond
+
 #endif /* RND_PRIORITY_QUEUE_H */
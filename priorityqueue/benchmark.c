@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <string.h>
+#include <RND_PriorityQueue.h>
+#include <RND_Utils.h>
+
+#define N 100000
+
+/* Pushes N elements with random priorities and then pops them all,
+ * once for each queue mode, checking that they come out in order.
+ * Each mode is run twice, pushing one element at a time and then
+ * all of them at once with RND_priorityQueuePushBatch.
+ */
+
+int priorities[N];
+RND_PriorityQueuePair pairs[N];
+
+double run(RND_PriorityQueue *queue, const char *name, bool batch)
+{
+    double start = RND_getWallTime_usec();
+    if (batch) {
+        RND_priorityQueuePushBatch(queue, pairs, N);
+    } else {
+        for (int i = 0; i < N; i++) {
+            RND_priorityQueuePush(queue, priorities + i, priorities[i]);
+        }
+    }
+    double mid = RND_getWallTime_usec();
+    int last = -1;
+    while (RND_priorityQueueSize(queue)) {
+        int priority = *(int*)RND_priorityQueuePeek(queue);
+        if (priority < last) {
+            printf("%s: elements popped out of order\n", name);
+            exit(EXIT_FAILURE);
+        }
+        last = priority;
+        RND_priorityQueuePop(queue, NULL);
+    }
+    double end = RND_getWallTime_usec();
+    printf("%-12s | %10.2f | %10.2f\n", name, (mid - start) / 1000, (end - mid) / 1000);
+    RND_priorityQueueDestroy(queue, NULL);
+    return end - start;
+}
+
+double runDary(size_t arity, const char *name)
+{
+    RND_PriorityQueueDary *queue = RND_priorityQueueDaryCreate(16, arity);
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < N; i++) {
+        RND_priorityQueueDaryPush(queue, priorities + i, priorities[i]);
+    }
+    double mid = RND_getWallTime_usec();
+    int last = -1;
+    while (RND_priorityQueueDarySize(queue)) {
+        int priority = *(int*)RND_priorityQueueDaryPeek(queue);
+        if (priority < last) {
+            printf("%s: elements popped out of order\n", name);
+            exit(EXIT_FAILURE);
+        }
+        last = priority;
+        RND_priorityQueueDaryPop(queue, NULL);
+    }
+    double end = RND_getWallTime_usec();
+    printf("%-12s | %10.2f | %10.2f\n", name, (mid - start) / 1000, (end - mid) / 1000);
+    RND_priorityQueueDaryDestroy(queue, NULL);
+    return end - start;
+}
+
+int main(int argc, char **argv)
+{
+    srand(1);
+    for (int i = 0; i < N; i++) {
+        priorities[i] = rand() % (N * 10);
+        RND_PriorityQueuePair pair = { priorities + i, priorities[i] };
+        memcpy(pairs + i, &pair, sizeof pair);
+    }
+    printf("%d random priorities\n", N);
+    printf("mode         |  push (ms) |   pop (ms)\n");
+    run(RND_priorityQueueCreate(16), "sorted", false);
+    run(RND_priorityQueueCreate(16), "sorted batch", true);
+    run(RND_priorityQueueCreateHeap(16), "heap", false);
+    run(RND_priorityQueueCreateHeap(16), "heap batch", true);
+    runDary(4, "4-ary");
+    runDary(8, "8-ary");
+    return EXIT_SUCCESS;
+}
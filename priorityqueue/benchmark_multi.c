@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <RND_PriorityQueue.h>
+#include <RND_Utils.h>
+
+#define MAX_THREADS 8
+#define PREFILL 100000
+#define OPS_PER_THREAD 200000
+
+/* Every thread alternates between pushing a new item with a random
+ * priority and taking an item out, like workers of a job scheduler
+ * that spawn and run jobs. The concurrent queue is compared against
+ * a single heap-ordered queue behind a global mutex. Afterwards the
+ * queues are drained and each item must have been taken exactly once.
+ */
+
+typedef struct Worker
+{
+    pthread_t thread;
+    int *items;
+    unsigned int seed;
+} Worker;
+
+RND_PriorityQueueMulti *multi_queue;
+RND_PriorityQueue *locked_queue;
+pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+int *items;
+unsigned char *seen;
+
+void mark(int *item)
+{
+    __atomic_add_fetch(seen + *item, 1, __ATOMIC_RELAXED);
+}
+
+int nextPriority(Worker *w)
+{
+    w->seed = w->seed * 1103515245 + 12345;
+    return (w->seed >> 8) % 1000000;
+}
+
+void *runMulti(void *arg)
+{
+    Worker *w = (Worker*)arg;
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        RND_priorityQueueMultiPush(multi_queue, w->items + i, nextPriority(w));
+        int *item;
+        if ((item = (int*)RND_priorityQueueMultiTake(multi_queue, NULL))) {
+            mark(item);
+        }
+    }
+    return NULL;
+}
+
+void *runLocked(void *arg)
+{
+    Worker *w = (Worker*)arg;
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        int priority = nextPriority(w);
+        pthread_mutex_lock(&lock);
+        RND_priorityQueuePush(locked_queue, w->items + i, priority);
+        pthread_mutex_unlock(&lock);
+        int *item;
+        pthread_mutex_lock(&lock);
+        if ((item = (int*)RND_priorityQueuePeek(locked_queue))) {
+            RND_priorityQueuePop(locked_queue, NULL);
+        }
+        pthread_mutex_unlock(&lock);
+        if (item) {
+            mark(item);
+        }
+    }
+    return NULL;
+}
+
+double run(int threads, bool multi)
+{
+    Worker workers[MAX_THREADS];
+    int total = PREFILL + threads * OPS_PER_THREAD;
+    for (int i = 0; i < total; i++) {
+        seen[i] = 0;
+    }
+    if (multi) {
+        multi_queue = RND_priorityQueueMultiCreate(4 * threads);
+    } else {
+        locked_queue = RND_priorityQueueCreateHeap(PREFILL);
+    }
+    for (int i = 0; i < PREFILL; i++) {
+        if (multi) {
+            RND_priorityQueueMultiPush(multi_queue, items + i, rand() % 1000000);
+        } else {
+            RND_priorityQueuePush(locked_queue, items + i, rand() % 1000000);
+        }
+    }
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < threads; i++) {
+        workers[i].items = items + PREFILL + i * OPS_PER_THREAD;
+        workers[i].seed = i + 1;
+        pthread_create(&workers[i].thread, NULL, multi? runMulti : runLocked, workers + i);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double end = RND_getWallTime_usec();
+    int *item;
+    if (multi) {
+        while ((item = (int*)RND_priorityQueueMultiTake(multi_queue, NULL))) {
+            mark(item);
+        }
+        RND_priorityQueueMultiDestroy(multi_queue, NULL);
+    } else {
+        while ((item = (int*)RND_priorityQueuePeek(locked_queue))) {
+            RND_priorityQueuePop(locked_queue, NULL);
+            mark(item);
+        }
+        RND_priorityQueueDestroy(locked_queue, NULL);
+    }
+    for (int i = 0; i < total; i++) {
+        if (seen[i] != 1) {
+            printf("item %d was taken %d times\n", i, seen[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return end - start;
+}
+
+int main(int argc, char **argv)
+{
+    int total = PREFILL + MAX_THREADS * OPS_PER_THREAD;
+    items = malloc(sizeof(int) * total);
+    seen = malloc(total);
+    for (int i = 0; i < total; i++) {
+        items[i] = i;
+    }
+    srand(1);
+    printf("%d prefilled items, %d push+take pairs per thread\n", PREFILL, OPS_PER_THREAD);
+    printf("THREADS | MUTEX (Mops/s) | MULTI (Mops/s)\n");
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        double ops = 2.0 * threads * OPS_PER_THREAD;
+        double locked = run(threads, false);
+        double multi  = run(threads, true);
+        printf("%7d | %14.2f | %14.2f\n", threads, ops / locked, ops / multi);
+    }
+    free(items);
+    free(seen);
+    return EXIT_SUCCESS;
+}
@@ -12,6 +12,11 @@ int push(RND_PriorityQueue *queue, int val, int priority)
     return RND_priorityQueuePush(queue, new, priority);
 }
 
+bool isEven(const void *value, int priority, void *arg)
+{
+    return *(const int*)value % 2 == 0;
+}
+
 int main(int argc, char **argv)
 {
     RND_PriorityQueue *test = RND_priorityQueueCreate(20);
@@ -33,6 +38,8 @@ int main(int argc, char **argv)
     RND_priorityQueuePrint(test);
     RND_priorityQueueRemove(test, 3, RND_priorityQueueDtorFree);
     RND_priorityQueueRemove(test, 13, RND_priorityQueueDtorFree);
+    // Remove any number of elements in one pass
+    RND_priorityQueueRemoveIf(test, isEven, NULL, RND_priorityQueueDtorFree);
     int *val;
     val = (int*)RND_priorityQueuePeek(test);
     printf("Peeked element with lowest priority: %p -> %d\n", val, *val);
@@ -44,5 +51,92 @@ int main(int argc, char **argv)
     RND_priorityQueueDestroy(test, RND_priorityQueueDtorFree);
     RND_priorityQueueDestroy(copy, NULL);
 
+    // Heap-ordered queues only keep the front element in place, but push in O(log n)
+    RND_PriorityQueue *heap = RND_priorityQueueCreateHeap(4);
+    push(heap, 1, 30);
+    push(heap, 2, 10);
+    push(heap, 3, 20);
+    push(heap, 4, 10);
+    push(heap, 5, 0);
+    RND_priorityQueuePop(heap, RND_priorityQueueDtorFree);
+    printf("heap order:");
+    while (RND_priorityQueueSize(heap)) {
+        printf(" %d", *(int*)RND_priorityQueuePeek(heap));
+        RND_priorityQueuePop(heap, RND_priorityQueueDtorFree);
+    }
+    printf("\n");
+    RND_priorityQueueDestroy(heap, RND_priorityQueueDtorFree);
+
+    // Everything due by a given time can be drained in one call
+    RND_PriorityQueue *timers = RND_priorityQueueCreate(8);
+    static const char *events[] = { "spawn", "blink", "save", "fade" };
+    for (int i = 0; i < 4; i++) {
+        RND_priorityQueuePush(timers, events[i], 100 * (4 - i));
+    }
+    void *due[4];
+    size_t count = RND_priorityQueuePopUntil(timers, 250, due, 4);
+    printf("due by 250:");
+    for (size_t i = 0; i < count; i++) {
+        printf(" %s", (const char*)due[i]);
+    }
+    printf(" (%lu left)\n", RND_priorityQueueSize(timers));
+    RND_priorityQueueDestroy(timers, NULL);
+
+    // Handles let you reprioritize or remove elements without searching for them
+    RND_PriorityQueue *tasks = RND_priorityQueueCreateHeap(8);
+    static const char *names[] = { "A", "B", "C", "D" };
+    RND_PriorityQueueHandle handles[4];
+    for (int i = 0; i < 4; i++) {
+        RND_priorityQueuePushHandle(tasks, names[i], 10 * (i + 1), handles + i);
+    }
+    RND_priorityQueueUpdate(tasks, handles[3], 5);
+    RND_priorityQueueRemoveHandle(tasks, handles[0], NULL);
+    printf("task order:");
+    while (RND_priorityQueueSize(tasks)) {
+        printf(" %s", (const char*)RND_priorityQueuePeek(tasks));
+        RND_priorityQueuePop(tasks, NULL);
+    }
+    printf("\n");
+    RND_priorityQueueDestroy(tasks, NULL);
+
+    // Typed variants take wider priorities, e.g. nanosecond deadlines or float costs
+    RND_PriorityQueueInt64 *deadlines = RND_priorityQueueInt64Create(4);
+    RND_priorityQueueInt64Push(deadlines, names[0], INT64_C(1500000000000));
+    RND_priorityQueueInt64Push(deadlines, names[1], INT64_C(1000000000001));
+    RND_priorityQueueInt64Push(deadlines, names[2], INT64_C(1000000000000));
+    printf("deadline order:");
+    while (RND_priorityQueueInt64Size(deadlines)) {
+        printf(" %s@%lld", (const char*)RND_priorityQueueInt64Peek(deadlines), (long long)deadlines->data[0].priority);
+        RND_priorityQueueInt64Pop(deadlines, NULL);
+    }
+    printf("\n");
+    RND_priorityQueueInt64Destroy(deadlines, NULL);
+
+    RND_PriorityQueueDouble *costs = RND_priorityQueueDoubleCreate(4);
+    RND_priorityQueueDoublePush(costs, names[0], 0.75);
+    RND_priorityQueueDoublePush(costs, names[1], 0.25);
+    RND_priorityQueueDoublePush(costs, names[2], 0.5);
+    printf("cost order:");
+    while (RND_priorityQueueDoubleSize(costs)) {
+        printf(" %s", (const char*)RND_priorityQueueDoublePeek(costs));
+        RND_priorityQueueDoublePop(costs, NULL);
+    }
+    printf("\n");
+    RND_priorityQueueDoubleDestroy(costs, NULL);
+
+    // A concurrent queue can be shared by many threads without a global lock
+    RND_PriorityQueueMulti *jobs = RND_priorityQueueMultiCreate(8);
+    for (int i = 0; i < 4; i++) {
+        RND_priorityQueueMultiPush(jobs, names[i], 4 - i);
+    }
+    printf("job order (relaxed):");
+    const char *job;
+    int priority;
+    while ((job = RND_priorityQueueMultiTake(jobs, &priority))) {
+        printf(" %s@%d", job, priority);
+    }
+    printf("\n");
+    RND_priorityQueueMultiDestroy(jobs, NULL);
+
     return EXIT_SUCCESS;
 }
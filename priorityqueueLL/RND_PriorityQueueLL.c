@@ -1,6 +1,7 @@
 #include <malloc.h>
 #include <stdio.h>
 #include <memory.h>
+#include <limits.h>
 #include <RND_ErrMsg.h>
 #include "RND_PriorityQueueLL.h"
 
@@ -186,3 +187,443 @@ int RND_priorityQueueLLPrint(const RND_PriorityQueueLL **queue)
     printf("+----------------------------------------------------+\n");
     return ret;
 }
+
+#define RND_PRIORITY_QUEUE_LL_POOL_MIN 16
+#define RND_PRIORITY_QUEUE_LL_POOL_MAX 4096
+
+// Access the pointer stored at the beginning of a free node or a block
+#define RND_POOL_LINK(p) (*(void**)(p))
+
+static void RND_priorityQueueLLPoolInit(RND_PriorityQueueLLPool *pool, size_t node_size)
+{
+    pool->free = pool->free_tail = NULL;
+    pool->blocks = pool->blocks_tail = NULL;
+    pool->node_size = node_size;
+    pool->block_capacity = RND_PRIORITY_QUEUE_LL_POOL_MIN;
+}
+
+static void *RND_priorityQueueLLPoolAlloc(RND_PriorityQueueLLPool *pool)
+{
+    if (!pool->free) {
+        /* The first node-sized slot of every block holds the link to
+         * the next block, the rest are threaded onto the free list.
+         */
+        char *block;
+        if (!(block = (char*)malloc((pool->block_capacity + 1) * pool->node_size))) {
+            RND_ERROR("malloc");
+            return NULL;
+        }
+        RND_POOL_LINK(block) = NULL;
+        if (pool->blocks_tail) {
+            RND_POOL_LINK(pool->blocks_tail) = block;
+        } else {
+            pool->blocks = block;
+        }
+        pool->blocks_tail = block;
+        for (size_t i = 1; i <= pool->block_capacity; i++) {
+            RND_POOL_LINK(block + i * pool->node_size) = (i < pool->block_capacity)? block + (i + 1) * pool->node_size : NULL;
+        }
+        pool->free = block + pool->node_size;
+        pool->free_tail = block + pool->block_capacity * pool->node_size;
+        if (pool->block_capacity < RND_PRIORITY_QUEUE_LL_POOL_MAX) {
+            pool->block_capacity *= 2;
+        }
+    }
+    void *node = pool->free;
+    if (!(pool->free = RND_POOL_LINK(node))) {
+        pool->free_tail = NULL;
+    }
+    return node;
+}
+
+static void RND_priorityQueueLLPoolFree(RND_PriorityQueueLLPool *pool, void *node)
+{
+    RND_POOL_LINK(node) = pool->free;
+    if (!pool->free) {
+        pool->free_tail = node;
+    }
+    pool->free = node;
+}
+
+// Hand all blocks and free nodes of src over to dst
+static void RND_priorityQueueLLPoolSplice(RND_PriorityQueueLLPool *dst, RND_PriorityQueueLLPool *src)
+{
+    if (src->blocks) {
+        if (dst->blocks_tail) {
+            RND_POOL_LINK(dst->blocks_tail) = src->blocks;
+        } else {
+            dst->blocks = src->blocks;
+        }
+        dst->blocks_tail = src->blocks_tail;
+    }
+    if (src->free) {
+        if (dst->free_tail) {
+            RND_POOL_LINK(dst->free_tail) = src->free;
+        } else {
+            dst->free = src->free;
+        }
+        dst->free_tail = src->free_tail;
+    }
+    if (src->block_capacity > dst->block_capacity) {
+        dst->block_capacity = src->block_capacity;
+    }
+    RND_priorityQueueLLPoolInit(src, src->node_size);
+}
+
+static void RND_priorityQueueLLPoolDestroy(RND_PriorityQueueLLPool *pool)
+{
+    void *block = pool->blocks;
+    while (block) {
+        void *next = RND_POOL_LINK(block);
+        free(block);
+        block = next;
+    }
+    RND_priorityQueueLLPoolInit(pool, pool->node_size);
+}
+
+// Make the root with the lower priority the parent of the other one
+static RND_PriorityQueueLLPairingNode *RND_priorityQueueLLPairingLink(RND_PriorityQueueLLPairingNode *a, RND_PriorityQueueLLPairingNode *b)
+{
+    if (b->priority < a->priority || (b->priority == a->priority && b->seq < a->seq)) {
+        RND_PriorityQueueLLPairingNode *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->sibling = a->child;
+    a->child = b;
+    a->sibling = NULL;
+    return a;
+}
+
+// Combine a list of siblings into a single tree (two-pass pairing)
+static RND_PriorityQueueLLPairingNode *RND_priorityQueueLLPairingMergePairs(RND_PriorityQueueLLPairingNode *first)
+{
+    // Link neighbours left to right, collecting the results in reverse
+    RND_PriorityQueueLLPairingNode *pairs = NULL;
+    while (first) {
+        RND_PriorityQueueLLPairingNode *a = first, *b = first->sibling;
+        if (b) {
+            first = b->sibling;
+            a = RND_priorityQueueLLPairingLink(a, b);
+        } else {
+            first = NULL;
+        }
+        a->sibling = pairs;
+        pairs = a;
+    }
+    // Link the pairs right to left into one tree
+    RND_PriorityQueueLLPairingNode *root = NULL;
+    while (pairs) {
+        RND_PriorityQueueLLPairingNode *next = pairs->sibling;
+        pairs->sibling = NULL;
+        root = root? RND_priorityQueueLLPairingLink(root, pairs) : pairs;
+        pairs = next;
+    }
+    return root;
+}
+
+RND_PriorityQueueLLPairing *RND_priorityQueueLLPairingCreate()
+{
+    RND_PriorityQueueLLPairing *heap;
+    if (!(heap = (RND_PriorityQueueLLPairing*)malloc(sizeof(RND_PriorityQueueLLPairing)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    heap->root = NULL;
+    heap->size = 0;
+    heap->next_seq = 0;
+    RND_priorityQueueLLPoolInit(&heap->pool, sizeof(RND_PriorityQueueLLPairingNode));
+    return heap;
+}
+
+int RND_priorityQueueLLPairingPush(RND_PriorityQueueLLPairing *heap, const void *data, int priority)
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 2;
+    }
+    RND_PriorityQueueLLPairingNode *new;
+    if (!(new = (RND_PriorityQueueLLPairingNode*)RND_priorityQueueLLPoolAlloc(&heap->pool))) {
+        RND_ERROR("RND_priorityQueueLLPoolAlloc");
+        return 1;
+    }
+    new->sibling = NULL;
+    new->child = NULL;
+    new->data = (void*)data;
+    new->priority = priority;
+    new->seq = heap->next_seq++;
+    heap->root = heap->root? RND_priorityQueueLLPairingLink(heap->root, new) : new;
+    heap->size++;
+    return 0;
+}
+
+void *RND_priorityQueueLLPairingPeek(const RND_PriorityQueueLLPairing *heap)
+{
+    return (heap && heap->root)? heap->root->data : NULL;
+}
+
+int RND_priorityQueueLLPairingPop(RND_PriorityQueueLLPairing *heap, int (*dtor)(const void*))
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 1;
+    }
+    if (!heap->root) {
+        RND_WARN("the heap is already empty");
+        return 1;
+    }
+    int error;
+    if (dtor && (error = dtor(heap->root->data))) {
+        RND_ERROR("dtor returned %d for data %p", error, heap->root->data);
+        return 2;
+    }
+    RND_PriorityQueueLLPairingNode *old = heap->root;
+    heap->root = RND_priorityQueueLLPairingMergePairs(old->child);
+    RND_priorityQueueLLPoolFree(&heap->pool, old);
+    heap->size--;
+    return 0;
+}
+
+int RND_priorityQueueLLPairingMeld(RND_PriorityQueueLLPairing *dst, RND_PriorityQueueLLPairing *src)
+{
+    if (!dst || !src || dst == src) {
+        RND_ERROR("the heaps do not exist or are the same heap");
+        return 1;
+    }
+    if (src->root) {
+        dst->root = dst->root? RND_priorityQueueLLPairingLink(dst->root, src->root) : src->root;
+    }
+    dst->size += src->size;
+    if (src->next_seq > dst->next_seq) {
+        dst->next_seq = src->next_seq;
+    }
+    RND_priorityQueueLLPoolSplice(&dst->pool, &src->pool);
+    src->root = NULL;
+    src->size = 0;
+    return 0;
+}
+
+int RND_priorityQueueLLPairingClear(RND_PriorityQueueLLPairing *heap, int (*dtor)(const void*))
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 2;
+    }
+    /* Walk the tree as a flat list, splicing each node's children
+     * in front of the rest, so that no recursion is needed.
+     */
+    RND_PriorityQueueLLPairingNode *node = heap->root;
+    while (node) {
+        if (node->child) {
+            RND_PriorityQueueLLPairingNode *last = node->child;
+            for (; last->sibling; last = last->sibling);
+            last->sibling = node->sibling;
+            node->sibling = node->child;
+            node->child = NULL;
+        }
+        int error;
+        if (dtor && (error = dtor(node->data))) {
+            RND_ERROR("dtor returned %d for data %p", error, node->data);
+            heap->root = RND_priorityQueueLLPairingMergePairs(node);
+            return 1;
+        }
+        RND_PriorityQueueLLPairingNode *next = node->sibling;
+        RND_priorityQueueLLPoolFree(&heap->pool, node);
+        heap->size--;
+        node = next;
+    }
+    heap->root = NULL;
+    return 0;
+}
+
+int RND_priorityQueueLLPairingDestroy(RND_PriorityQueueLLPairing *heap, int (*dtor)(const void*))
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 2;
+    }
+    int error;
+    if ((error = RND_priorityQueueLLPairingClear(heap, dtor))) {
+        RND_ERROR("RND_priorityQueueLLPairingClear returned error %d", error);
+        return error;
+    }
+    RND_priorityQueueLLPoolDestroy(&heap->pool);
+    free(heap);
+    return 0;
+}
+
+size_t RND_priorityQueueLLPairingSize(const RND_PriorityQueueLLPairing *heap)
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 0;
+    }
+    return heap->size;
+}
+
+// Find the bucket of a priority: 0 if equal to last, else 1 + the highest differing bit
+static size_t RND_priorityQueueLLRadixBucket(int priority, int last)
+{
+    unsigned int diff = (unsigned int)priority ^ (unsigned int)last;
+    return diff? sizeof(int) * CHAR_BIT - __builtin_clz(diff) : 0;
+}
+
+static void RND_priorityQueueLLRadixAppend(RND_PriorityQueueLLRadix *heap, size_t bucket, RND_PriorityQueueLLRadixNode *node)
+{
+    node->next = NULL;
+    if (heap->tail[bucket]) {
+        heap->tail[bucket]->next = node;
+    } else {
+        heap->head[bucket] = node;
+    }
+    heap->tail[bucket] = node;
+}
+
+/* Make sure bucket 0 holds the front elements by moving last up to
+ * the minimum of the first non-empty bucket and redistributing it.
+ * Every element of that bucket lands in a strictly lower one.
+ */
+static void RND_priorityQueueLLRadixSettle(RND_PriorityQueueLLRadix *heap)
+{
+    if (heap->head[0] || !heap->size) {
+        return;
+    }
+    size_t i = 1;
+    for (; !heap->head[i]; i++);
+    RND_PriorityQueueLLRadixNode *node = heap->head[i];
+    int min = node->priority;
+    for (; node; node = node->next) {
+        if (node->priority < min) {
+            min = node->priority;
+        }
+    }
+    heap->last = min;
+    node = heap->head[i];
+    heap->head[i] = heap->tail[i] = NULL;
+    while (node) {
+        RND_PriorityQueueLLRadixNode *next = node->next;
+        RND_priorityQueueLLRadixAppend(heap, RND_priorityQueueLLRadixBucket(node->priority, min), node);
+        node = next;
+    }
+}
+
+RND_PriorityQueueLLRadix *RND_priorityQueueLLRadixCreate()
+{
+    RND_PriorityQueueLLRadix *heap;
+    if (!(heap = (RND_PriorityQueueLLRadix*)malloc(sizeof(RND_PriorityQueueLLRadix)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    for (size_t i = 0; i < RND_PRIORITY_QUEUE_LL_RADIX_BUCKETS; i++) {
+        heap->head[i] = heap->tail[i] = NULL;
+    }
+    heap->last = INT_MIN;
+    heap->size = 0;
+    RND_priorityQueueLLPoolInit(&heap->pool, sizeof(RND_PriorityQueueLLRadixNode));
+    return heap;
+}
+
+int RND_priorityQueueLLRadixPush(RND_PriorityQueueLLRadix *heap, const void *data, int priority)
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 2;
+    }
+    if (priority < heap->last) {
+        RND_ERROR("priority %d is lower than the last taken priority %d", priority, heap->last);
+        return 3;
+    }
+    RND_PriorityQueueLLRadixNode *new;
+    if (!(new = (RND_PriorityQueueLLRadixNode*)RND_priorityQueueLLPoolAlloc(&heap->pool))) {
+        RND_ERROR("RND_priorityQueueLLPoolAlloc");
+        return 1;
+    }
+    new->data = (void*)data;
+    new->priority = priority;
+    RND_priorityQueueLLRadixAppend(heap, RND_priorityQueueLLRadixBucket(priority, heap->last), new);
+    heap->size++;
+    return 0;
+}
+
+void *RND_priorityQueueLLRadixPeek(RND_PriorityQueueLLRadix *heap)
+{
+    if (!heap || !heap->size) {
+        return NULL;
+    }
+    RND_priorityQueueLLRadixSettle(heap);
+    return heap->head[0]->data;
+}
+
+int RND_priorityQueueLLRadixPop(RND_PriorityQueueLLRadix *heap, int (*dtor)(const void*))
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 1;
+    }
+    if (!heap->size) {
+        RND_WARN("the heap is already empty");
+        return 1;
+    }
+    RND_priorityQueueLLRadixSettle(heap);
+    RND_PriorityQueueLLRadixNode *old = heap->head[0];
+    int error;
+    if (dtor && (error = dtor(old->data))) {
+        RND_ERROR("dtor returned %d for data %p", error, old->data);
+        return 2;
+    }
+    if (!(heap->head[0] = old->next)) {
+        heap->tail[0] = NULL;
+    }
+    RND_priorityQueueLLPoolFree(&heap->pool, old);
+    heap->size--;
+    return 0;
+}
+
+int RND_priorityQueueLLRadixClear(RND_PriorityQueueLLRadix *heap, int (*dtor)(const void*))
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 2;
+    }
+    for (size_t i = 0; i < RND_PRIORITY_QUEUE_LL_RADIX_BUCKETS; i++) {
+        while (heap->head[i]) {
+            RND_PriorityQueueLLRadixNode *old = heap->head[i];
+            int error;
+            if (dtor && (error = dtor(old->data))) {
+                RND_ERROR("dtor returned %d for data %p", error, old->data);
+                return 1;
+            }
+            if (!(heap->head[i] = old->next)) {
+                heap->tail[i] = NULL;
+            }
+            RND_priorityQueueLLPoolFree(&heap->pool, old);
+            heap->size--;
+        }
+    }
+    return 0;
+}
+
+int RND_priorityQueueLLRadixDestroy(RND_PriorityQueueLLRadix *heap, int (*dtor)(const void*))
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 2;
+    }
+    int error;
+    if ((error = RND_priorityQueueLLRadixClear(heap, dtor))) {
+        RND_ERROR("RND_priorityQueueLLRadixClear returned error %d", error);
+        return error;
+    }
+    RND_priorityQueueLLPoolDestroy(&heap->pool);
+    free(heap);
+    return 0;
+}
+
+size_t RND_priorityQueueLLRadixSize(const RND_PriorityQueueLLRadix *heap)
+{
+    if (!heap) {
+        RND_ERROR("the heap does not exist");
+        return 0;
+    }
+    return heap->size;
+}
@@ -14,6 +14,14 @@
 #define RND_PRIORITY_QUEUE_LL_H
 
 #include <stdlib.h>
+#include <limits.h>
+
+/********************************************************
+ *                      CONSTANTS                       *
+ ********************************************************/
+
+/// The number of buckets in a @ref RND_PriorityQueueLLRadix.
+#define RND_PRIORITY_QUEUE_LL_RADIX_BUCKETS (sizeof(int) * CHAR_BIT + 1)
 
 /********************************************************
  *                     STRUCTURES                       *
@@ -22,6 +30,11 @@
 /// @cond
 typedef struct RND_PriorityQueueLL RND_PriorityQueueLL;
 typedef struct RND_PriorityQueueLLPair RND_PriorityQueueLLPair;
+typedef struct RND_PriorityQueueLLPool RND_PriorityQueueLLPool;
+typedef struct RND_PriorityQueueLLPairingNode RND_PriorityQueueLLPairingNode;
+typedef struct RND_PriorityQueueLLPairing RND_PriorityQueueLLPairing;
+typedef struct RND_PriorityQueueLLRadixNode RND_PriorityQueueLLRadixNode;
+typedef struct RND_PriorityQueueLLRadix RND_PriorityQueueLLRadix;
 /// @endcond
 
 /** A structure for storing a data-priority pair.
@@ -63,6 +76,114 @@ struct RND_PriorityQueueLL
     RND_PriorityQueueLL *next;
 };
 
+/** A node allocator used by the pairing and radix heaps.
+ *
+ * Nodes are carved out of blocks that grow geometrically,
+ * and removed nodes are kept on a free list for reuse, so
+ * pushing an element costs one pointer pop instead of
+ * a @c malloc call. Blocks are only given back to the system
+ * when the owning heap is destroyed.
+ *
+ * You should never need to touch this struct directly.
+ */
+struct RND_PriorityQueueLLPool
+{
+    /// The first free node (its first pointer links to the next one).
+    void *free;
+    /// The last free node, so that free lists can be joined in O(1).
+    void *free_tail;
+    /// The first allocated block (its first pointer links to the next one).
+    void *blocks;
+    /// The last allocated block.
+    void *blocks_tail;
+    /// The size of a single node in bytes.
+    size_t node_size;
+    /// The number of nodes to allocate in the next block.
+    size_t block_capacity;
+};
+
+/** A single element of a @ref RND_PriorityQueueLLPairing.
+ *
+ * Each node keeps a list of its children (@ref child, then
+ * following @ref sibling), and every child has a priority not
+ * lower than its parent's.
+ */
+struct RND_PriorityQueueLLPairingNode
+{
+    /// The next child of the same parent.
+    RND_PriorityQueueLLPairingNode *sibling;
+    /// The first child of this node.
+    RND_PriorityQueueLLPairingNode *child;
+    /// A pointer to the stored data.
+    void *data;
+    /// The priority of the element.
+    int priority;
+    /// The insertion counter, used to keep equal priorities in FIFO order.
+    size_t seq;
+};
+
+/** A pairing heap, a faster replacement for @ref RND_PriorityQueueLL.
+ *
+ * Elements are ordered the same way as in @ref RND_PriorityQueueLL
+ * (lowest priority first, equal priorities in insertion order),
+ * but pushing is O(1) instead of walking the list, popping is
+ * amortized O(log n), and two heaps can be merged in O(1) with
+ * @ref RND_priorityQueueLLPairingMeld. Each element takes exactly
+ * one node, allocated from the heap's own @ref RND_PriorityQueueLLPool.
+ */
+struct RND_PriorityQueueLLPairing
+{
+    /// The front element of the heap (@c NULL if empty).
+    RND_PriorityQueueLLPairingNode *root;
+    /// The number of elements in the heap.
+    size_t size;
+    /// The insertion counter for the next pushed element.
+    size_t next_seq;
+    /// The node allocator.
+    RND_PriorityQueueLLPool pool;
+};
+
+/** A single element of a @ref RND_PriorityQueueLLRadix.
+ */
+struct RND_PriorityQueueLLRadixNode
+{
+    /// The next element in the same bucket.
+    RND_PriorityQueueLLRadixNode *next;
+    /// A pointer to the stored data.
+    void *data;
+    /// The priority of the element.
+    int priority;
+};
+
+/** A radix heap for monotone integer priorities.
+ *
+ * A radix heap only works if no element is ever pushed with
+ * a priority lower than that of the last element taken out,
+ * which is the case e.g. in Dijkstra's algorithm or in event
+ * simulations. In return, pushing is O(1) and popping is
+ * amortized O(log C), where C is the range of priorities,
+ * with no comparisons between unrelated elements at all.
+ *
+ * Elements are kept in buckets according to the highest bit
+ * in which their priority differs from @ref last. Equal
+ * priorities are popped in insertion order, and each element
+ * takes exactly one node from the heap's own @ref
+ * RND_PriorityQueueLLPool.
+ */
+struct RND_PriorityQueueLLRadix
+{
+    /// The first element of each bucket.
+    RND_PriorityQueueLLRadixNode *head[RND_PRIORITY_QUEUE_LL_RADIX_BUCKETS];
+    /// The last element of each bucket.
+    RND_PriorityQueueLLRadixNode *tail[RND_PRIORITY_QUEUE_LL_RADIX_BUCKETS];
+    /// The lowest priority that can still be pushed.
+    int last;
+    /// The number of elements in the heap.
+    size_t size;
+    /// The node allocator.
+    RND_PriorityQueueLLPool pool;
+};
+
 
 /********************************************************
  *                      FUNCTIONS                       *
@@ -235,4 +356,186 @@ int RND_priorityQueueLLPrintMap(const RND_PriorityQueueLL *elem, size_t index);
  */
 int RND_priorityQueueLLDtorFree(const void *data);
 
+/** Allocates a new empty pairing heap and returns its pointer.
+ *
+ * @returns
+ * - the new heap's address - success
+ * - @c NULL - insufficient memory
+ */
+RND_PriorityQueueLLPairing *RND_priorityQueueLLPairingCreate();
+
+/** Inserts an element into a pairing heap in O(1).
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] data The address of the data to be stored.
+ * @param[in] priority The priority for the new element.
+ * Elements with lower priority precede elements with
+ * higher priority.
+ * @returns
+ * - 0 - success
+ * - 1 - insufficient memory
+ * - 2 - @p heap is @c NULL
+ */
+int RND_priorityQueueLLPairingPush(RND_PriorityQueueLLPairing *heap, const void *data, int priority);
+
+/** Returns a pointer to the front element of a pairing heap.
+ *
+ * @param[in] heap A pointer to the heap.
+ * @returns
+ * - the front element's @ref RND_PriorityQueueLLPairingNode::data - success
+ * - @c NULL - the heap is empty or @p heap is @c NULL
+ */
+void *RND_priorityQueueLLPairingPeek(const RND_PriorityQueueLLPairing *heap);
+
+/** Removes the front element of a pairing heap.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] dtor A pointer to a function which intakes
+ * @ref RND_PriorityQueueLLPairingNode::data and frees it, returning
+ * 0 for success and anything else for failure @b OR @c NULL
+ * if the data doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - the heap is empty or @p heap is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_priorityQueueLLPairingPop(RND_PriorityQueueLLPairing *heap, int (*dtor)(const void*));
+
+/** Moves all elements of one pairing heap into another in O(1).
+ *
+ * The nodes and memory blocks of @p src are handed over to
+ * @p dst, after which @p src is empty but still has to be
+ * destroyed as usual. Elements of equal priority coming from
+ * different heaps are not guaranteed to keep any particular order.
+ *
+ * @param[inout] dst A pointer to the heap receiving the elements.
+ * @param[inout] src A pointer to the heap giving away the elements.
+ * @returns
+ * - 0 - success
+ * - 1 - @p dst or @p src is @c NULL, or they are the same heap
+ */
+int RND_priorityQueueLLPairingMeld(RND_PriorityQueueLLPairing *dst, RND_PriorityQueueLLPairing *src);
+
+/** Removes all elements from a pairing heap.
+ *
+ * The memory of removed nodes is kept for reuse. If some
+ * @p dtor call fails, the remaining elements are still
+ * a valid heap.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] dtor Same as in @ref RND_priorityQueueLLPairingPop.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0
+ * - 2 - @p heap is @c NULL
+ */
+int RND_priorityQueueLLPairingClear(RND_PriorityQueueLLPairing *heap, int (*dtor)(const void*));
+
+/** Frees all memory associated with a pairing heap.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_priorityQueueLLPairingClear.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0 (the heap is not freed)
+ * - 2 - @p heap is @c NULL
+ */
+int RND_priorityQueueLLPairingDestroy(RND_PriorityQueueLLPairing *heap, int (*dtor)(const void*));
+
+/** Returns the number of elements in a pairing heap.
+ *
+ * @param[in] heap A pointer to the heap.
+ * @returns
+ * - the size of the heap - success
+ * - 0 - if @p heap is @c NULL (or heap is empty)
+ */
+size_t RND_priorityQueueLLPairingSize(const RND_PriorityQueueLLPairing *heap);
+
+/** Allocates a new empty radix heap and returns its pointer.
+ *
+ * @returns
+ * - the new heap's address - success
+ * - @c NULL - insufficient memory
+ */
+RND_PriorityQueueLLRadix *RND_priorityQueueLLRadixCreate();
+
+/** Inserts an element into a radix heap in O(1).
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] data The address of the data to be stored.
+ * @param[in] priority The priority for the new element. It must
+ * not be lower than the priority of the last element popped
+ * or peeked (@ref RND_PriorityQueueLLRadix::last).
+ * @returns
+ * - 0 - success
+ * - 1 - insufficient memory
+ * - 2 - @p heap is @c NULL
+ * - 3 - @p priority is lower than @ref RND_PriorityQueueLLRadix::last
+ */
+int RND_priorityQueueLLRadixPush(RND_PriorityQueueLLRadix *heap, const void *data, int priority);
+
+/** Returns a pointer to the front element of a radix heap.
+ *
+ * Finding the front element may require redistributing
+ * one bucket, which is why @p heap is not @c const.
+ * Afterwards, @ref RND_PriorityQueueLLRadix::last equals
+ * the front element's priority.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @returns
+ * - the front element's @ref RND_PriorityQueueLLRadixNode::data - success
+ * - @c NULL - the heap is empty or @p heap is @c NULL
+ */
+void *RND_priorityQueueLLRadixPeek(RND_PriorityQueueLLRadix *heap);
+
+/** Removes the front element of a radix heap.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] dtor A pointer to a function which intakes
+ * @ref RND_PriorityQueueLLRadixNode::data and frees it, returning
+ * 0 for success and anything else for failure @b OR @c NULL
+ * if the data doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - the heap is empty or @p heap is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_priorityQueueLLRadixPop(RND_PriorityQueueLLRadix *heap, int (*dtor)(const void*));
+
+/** Removes all elements from a radix heap.
+ *
+ * The memory of removed nodes is kept for reuse and
+ * @ref RND_PriorityQueueLLRadix::last is left unchanged.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] dtor Same as in @ref RND_priorityQueueLLRadixPop.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0
+ * - 2 - @p heap is @c NULL
+ */
+int RND_priorityQueueLLRadixClear(RND_PriorityQueueLLRadix *heap, int (*dtor)(const void*));
+
+/** Frees all memory associated with a radix heap.
+ *
+ * @param[inout] heap A pointer to the heap.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_priorityQueueLLRadixClear.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0 (the heap is not freed)
+ * - 2 - @p heap is @c NULL
+ */
+int RND_priorityQueueLLRadixDestroy(RND_PriorityQueueLLRadix *heap, int (*dtor)(const void*));
+
+/** Returns the number of elements in a radix heap.
+ *
+ * @param[in] heap A pointer to the heap.
+ * @returns
+ * - the size of the heap - success
+ * - 0 - if @p heap is @c NULL (or heap is empty)
+ */
+size_t RND_priorityQueueLLRadixSize(const RND_PriorityQueueLLRadix *heap);
+
 #endif /* RND_PRIORITY_QUEUE_LL_H */
@@ -38,5 +38,41 @@ int main(int argc, char **argv)
     RND_priorityQueueLLPrint(&test);
     RND_priorityQueueLLDestroy(&test, RND_priorityQueueLLDtorFree);
 
+    // A pairing heap gives the same order without walking a list on every push
+    static const char *names[] = { "A", "B", "C", "D", "E" };
+    RND_PriorityQueueLLPairing *a = RND_priorityQueueLLPairingCreate(),
+                               *b = RND_priorityQueueLLPairingCreate();
+    RND_priorityQueueLLPairingPush(a, names[0], 7);
+    RND_priorityQueueLLPairingPush(a, names[1], 2);
+    RND_priorityQueueLLPairingPush(b, names[2], 5);
+    RND_priorityQueueLLPairingPush(b, names[3], 1);
+    RND_priorityQueueLLPairingPush(b, names[4], 5);
+    RND_priorityQueueLLPairingMeld(a, b);
+    printf("pairing heap order:");
+    while (RND_priorityQueueLLPairingSize(a)) {
+        printf(" %s", (const char*)RND_priorityQueueLLPairingPeek(a));
+        RND_priorityQueueLLPairingPop(a, NULL);
+    }
+    printf("\n");
+    RND_priorityQueueLLPairingDestroy(a, NULL);
+    RND_priorityQueueLLPairingDestroy(b, NULL);
+
+    // A radix heap accepts any priority not lower than the last one taken out
+    RND_PriorityQueueLLRadix *r = RND_priorityQueueLLRadixCreate();
+    RND_priorityQueueLLRadixPush(r, names[0], 40);
+    RND_priorityQueueLLRadixPush(r, names[1], 10);
+    RND_priorityQueueLLRadixPush(r, names[2], 25);
+    printf("radix heap order:");
+    printf(" %s", (const char*)RND_priorityQueueLLRadixPeek(r));
+    RND_priorityQueueLLRadixPop(r, NULL);
+    RND_priorityQueueLLRadixPush(r, names[3], 10);
+    RND_priorityQueueLLRadixPush(r, names[4], 30);
+    while (RND_priorityQueueLLRadixSize(r)) {
+        printf(" %s", (const char*)RND_priorityQueueLLRadixPeek(r));
+        RND_priorityQueueLLRadixPop(r, NULL);
+    }
+    printf("\n");
+    RND_priorityQueueLLRadixDestroy(r, NULL);
+
     return EXIT_SUCCESS;
 }
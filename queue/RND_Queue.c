@@ -1,5 +1,6 @@
 #include <malloc.h>
 #include <stdio.h>
+#include <string.h>
 #include <RND_ErrMsg.h>
 #include "RND_Queue.h"
 
@@ -226,3 +227,155 @@ int RND_queueCopy(RND_Queue *dest, const RND_Queue *src, void* (*cpy)(const void
     dest->tail = dest->data + (src->tail - src->data);
     return 0;
 }
+
+RND_QueueInline *RND_queueInlineCreate(size_t capacity, size_t elem_size)
+{
+    RND_QueueInline *queue;
+    if (!(queue = malloc(sizeof(RND_QueueInline)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    if (!capacity || !elem_size) {
+        RND_ERROR("capacity and elem_size must be positive values");
+        free(queue);
+        return NULL;
+    }
+    if (!(queue->data = malloc(elem_size * capacity))) {
+        RND_ERROR("malloc");
+        free(queue);
+        return NULL;
+    }
+    queue->size = 0;
+    queue->head = 0;
+    queue->capacity = capacity;
+    queue->elem_size = elem_size;
+    return queue;
+}
+
+int RND_queueInlinePush(RND_QueueInline *queue, const void *elem)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (queue->size == queue->capacity) {
+        /* Unroll the loop into the new block with at most two
+         * memcpy calls, so that the head lands at index 0 again.
+         */
+        char *new;
+        if (!(new = malloc(queue->elem_size * queue->capacity * 2))) {
+            RND_ERROR("malloc");
+            return 2;
+        }
+        size_t first = queue->capacity - queue->head;
+        memcpy(new, queue->data + queue->elem_size * queue->head, queue->elem_size * first);
+        memcpy(new + queue->elem_size * first, queue->data, queue->elem_size * queue->head);
+        free(queue->data);
+        queue->data = new;
+        queue->head = 0;
+        queue->capacity *= 2;
+    }
+    size_t tail = (queue->head + queue->size) % queue->capacity;
+    memcpy(queue->data + queue->elem_size * tail, elem, queue->elem_size);
+    queue->size++;
+    return 0;
+}
+
+void *RND_queueInlinePeek(const RND_QueueInline *queue)
+{
+    return (queue && queue->size > 0)? queue->data + queue->elem_size * queue->head : NULL;
+}
+
+int RND_queueInlinePop(RND_QueueInline *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (queue->size > 0) {
+        int error;
+        void *elem = queue->data + queue->elem_size * queue->head;
+        if (dtor && (error = dtor(elem))) {
+            RND_ERROR("dtor returned %d for element %p", error, elem);
+            return 2;
+        }
+        queue->head = (queue->head + 1 == queue->capacity)? 0 : queue->head + 1;
+        queue->size--;
+    } else {
+        RND_WARN("the queue is already empty");
+    }
+    return 0;
+}
+
+int RND_queueInlineRemove(RND_QueueInline *queue, size_t index, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (index >= queue->size) {
+        RND_ERROR("index out of range");
+        return 3;
+    }
+    size_t elem = (queue->head + index) % queue->capacity;
+    int error;
+    if (dtor && (error = dtor(queue->data + queue->elem_size * elem))) {
+        RND_ERROR("dtor returned %d for element %p", error, (void*)(queue->data + queue->elem_size * elem));
+        return 2;
+    }
+    for (size_t i = index + 1; i < queue->size; i++) {
+        size_t src = (elem + 1 == queue->capacity)? 0 : elem + 1;
+        memcpy(queue->data + queue->elem_size * elem, queue->data + queue->elem_size * src, queue->elem_size);
+        elem = src;
+    }
+    queue->size--;
+    return 0;
+}
+
+int RND_queueInlineClear(RND_QueueInline *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    if (dtor) {
+        while (queue->size) {
+            int error;
+            void *elem = queue->data + queue->elem_size * queue->head;
+            if ((error = dtor(elem))) {
+                RND_ERROR("dtor returned %d for element %p", error, elem);
+                return 2;
+            }
+            queue->head = (queue->head + 1 == queue->capacity)? 0 : queue->head + 1;
+            queue->size--;
+        }
+    } else {
+        queue->size = 0;
+    }
+    return 0;
+}
+
+int RND_queueInlineDestroy(RND_QueueInline *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_queueInlineClear(queue, dtor))) {
+        RND_ERROR("RND_queueInlineClear returned error %d", error);
+        return error;
+    }
+    free(queue->data);
+    free(queue);
+    return 0;
+}
+
+size_t RND_queueInlineSize(const RND_QueueInline *queue)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 0;
+    }
+    return queue->size;
+}
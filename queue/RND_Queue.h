@@ -16,6 +16,7 @@
 
 /// @cond
 typedef struct RND_Queue RND_Queue;
+typedef struct RND_QueueInline RND_QueueInline;
 /// @endcond
 
 /** A FIFO queue structure for arbitrary data.
@@ -45,6 +46,29 @@ struct RND_Queue
     size_t capacity;
 };
 
+/** A FIFO queue structure storing elements by value.
+ *
+ * This is the by-value counterpart of @ref RND_Queue. Instead
+ * of pointers, whole elements of a fixed size (set at the time
+ * of creation) are copied into the looped @ref
+ * RND_QueueInline::data block, so small records can be queued
+ * without allocating each of them separately.
+ */
+struct RND_QueueInline
+{
+    /// A contiguous array of the stored elements.
+    char *data;
+    /// The number of elements on the queue.
+    size_t size;
+    /// The index of the first element.
+    size_t head;
+    /// The number of elements the @ref RND_QueueInline::data
+    /// array can hold (this number will change dynamically).
+    size_t capacity;
+    /// The size of a single element (in bytes).
+    size_t elem_size;
+};
+
 
 /********************************************************
  *                      FUNCTIONS                       *
@@ -205,4 +229,102 @@ int RND_queueDtorFree(const void *data);
  */
 int RND_queueCopy(RND_Queue *dest, const RND_Queue *src, void* (*cpy)(const void *));
 
+/** Allocates a new empty by-value queue and returns its pointer.
+ *
+ * @param[in] capacity The number of elements to preallocate
+ * for (cannot be 0). This number will be automatically doubled each
+ * time more space is needed due to pushing elements.
+ * @param[in] elem_size The size of a single element in bytes
+ * (cannot be 0), usually @c sizeof of the stored type.
+ * @returns
+ * - the new queue's address - success
+ * - @c NULL - insufficient memory or invalid @p capacity
+ *   or @p elem_size value
+ */
+RND_QueueInline *RND_queueInlineCreate(size_t capacity, size_t elem_size);
+
+/** Copies an element to the end of a by-value queue.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] elem A pointer to the element to be copied
+ * (@ref RND_QueueInline::elem_size bytes are read).
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - malloc failed (insufficient memory)
+ */
+int RND_queueInlinePush(RND_QueueInline *queue, const void *elem);
+
+/** Returns a pointer to the front element of a by-value queue.
+ *
+ * The returned pointer points inside @ref RND_QueueInline::data,
+ * so it is only valid until the next push or removal.
+ *
+ * @param[in] queue A pointer to the queue.
+ * @returns
+ * - the address of the front element - success
+ * - @c NULL - @p queue is @c NULL or empty
+ */
+void *RND_queueInlinePeek(const RND_QueueInline *queue);
+
+/** Removes the front element from a by-value queue.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] dtor A pointer to a function which intakes
+ * the address of an element and frees whatever it owns
+ * (but not the element itself), returning 0 for success
+ * and anything else for failure @b OR @c NULL if the
+ * elements don't need any cleanup.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_queueInlinePop(RND_QueueInline *queue, int (*dtor)(const void*));
+
+/** Removes an element from a by-value queue by index.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] index The index of the element to remove (starting at head = 0).
+ * @param[in] dtor Same as in @ref RND_queueInlinePop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ * - 3 - @p index out of range
+ */
+int RND_queueInlineRemove(RND_QueueInline *queue, size_t index, int (*dtor)(const void*));
+
+/** Removes all elements from a by-value queue.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[in] dtor Same as in @ref RND_queueInlinePop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_queueInlineClear(RND_QueueInline *queue, int (*dtor)(const void*));
+
+/** Frees all memory associated with a by-value queue.
+ *
+ * First frees the contents of a queue with @ref
+ * RND_queueInlineClear, then frees the @ref RND_QueueInline
+ * struct itself.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param [in] dtor This argument is passed directly
+ * to @ref RND_queueInlineClear.
+ */
+int RND_queueInlineDestroy(RND_QueueInline *queue, int (*dtor)(const void*));
+
+/** Returns the number of elements in a by-value queue.
+ *
+ * @param[in] queue A pointer to the queue.
+ * @returns
+ * - the size of the queue (@ref RND_QueueInline::size) - success
+ * - 0 - if @p queue is @c NULL (or queue is empty)
+ */
+size_t RND_queueInlineSize(const RND_QueueInline *queue);
+
 #endif /* RND_QUEUE_H */
@@ -13,6 +13,11 @@ int push(RND_Queue *queue, int val)
     return RND_queuePush(queue, new);
 }
 
+typedef struct Point
+{
+    int x, y;
+} Point;
+
 int main(int argc, char **argv)
 {
     RND_Queue *test = RND_queueCreate(10);
@@ -48,5 +53,19 @@ int main(int argc, char **argv)
     RND_queueDestroy(test, RND_queueDtorFree);
     RND_queueDestroy(copy, NULL);
 
+    // Small records can be stored by value, without mallocing each of them
+    RND_QueueInline *points = RND_queueInlineCreate(4, sizeof(Point));
+    for (int i = 0; i < 10; i++) {
+        Point p = { i, i * i };
+        RND_queueInlinePush(points, &p);
+        if (i % 3 == 0) {
+            RND_queueInlinePop(points, NULL);
+        }
+    }
+    RND_queueInlineRemove(points, 1, NULL);
+    Point *front = (Point*)RND_queueInlinePeek(points);
+    printf("front point: (%d, %d), size: %lu\n", front->x, front->y, RND_queueInlineSize(points));
+    RND_queueInlineDestroy(points, NULL);
+
     return EXIT_SUCCESS;
 }
@@ -169,3 +169,218 @@ int RND_queueLLPrint(const RND_QueueLL **queue)
     printf("+-----------------------------------------+\n");
     return ret;
 }
+
+RND_QueueLLHandle *RND_queueLLHandleCreate()
+{
+    RND_QueueLLHandle *queue;
+    if (!(queue = (RND_QueueLLHandle*)malloc(sizeof(RND_QueueLLHandle)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->size = 0;
+    return queue;
+}
+
+int RND_queueLLHandlePush(RND_QueueLLHandle *queue, const void *data)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 2;
+    }
+    RND_QueueLL *new;
+    if (!(new = (RND_QueueLL*)malloc(sizeof(RND_QueueLL)))) {
+        RND_ERROR("malloc");
+        return 1;
+    }
+    new->data = (void*)data;
+    new->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = new;
+    } else {
+        queue->head = new;
+    }
+    queue->tail = new;
+    queue->size++;
+    return 0;
+}
+
+void *RND_queueLLHandlePeek(const RND_QueueLLHandle *queue)
+{
+    return (queue && queue->head)? queue->head->data : NULL;
+}
+
+int RND_queueLLHandlePop(RND_QueueLLHandle *queue, int (*dtor)(const void*))
+{
+    if (!queue || !queue->head) {
+        RND_WARN("the queue is already empty");
+        return 1;
+    }
+    RND_QueueLL *next = queue->head->next;
+    int error;
+    if (dtor && (error = dtor(queue->head->data))) {
+        RND_ERROR("dtor returned %d for data %p", error, queue->head->data);
+        return 2;
+    }
+    free(queue->head);
+    queue->head = next;
+    if (!next) {
+        queue->tail = NULL;
+    }
+    queue->size--;
+    return 0;
+}
+
+int RND_queueLLHandleRemove(RND_QueueLLHandle *queue, size_t index, int (*dtor)(const void*))
+{
+    if (!queue || !queue->head) {
+        RND_WARN("the queue is already empty");
+        return 1;
+    }
+    if (index >= queue->size) {
+        RND_ERROR("index %lu out of bounds (size %lu)", index, queue->size);
+        return 3;
+    }
+    if (index == 0) {
+        return RND_queueLLHandlePop(queue, dtor);
+    }
+    RND_QueueLL *prev = queue->head;
+    for (size_t i = 0; i < index - 1; i++) {
+        prev = prev->next;
+    }
+    RND_QueueLL *target = prev->next;
+    int error;
+    if (dtor && (error = dtor(target->data))) {
+        RND_ERROR("dtor returned %d for data %p", error, target->data);
+        return 2;
+    }
+    prev->next = target->next;
+    if (target == queue->tail) {
+        queue->tail = prev;
+    }
+    free(target);
+    queue->size--;
+    return 0;
+}
+
+int RND_queueLLHandleClear(RND_QueueLLHandle *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 2;
+    }
+    while (queue->head) {
+        RND_QueueLL *next = queue->head->next;
+        int error;
+        if (dtor && (error = dtor(queue->head->data))) {
+            RND_ERROR("dtor returned %d for data %p", error, queue->head->data);
+            return 1;
+        }
+        free(queue->head);
+        queue->head = next;
+        queue->size--;
+    }
+    queue->tail = NULL;
+    return 0;
+}
+
+int RND_queueLLHandleDestroy(RND_QueueLLHandle *queue, int (*dtor)(const void*))
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 2;
+    }
+    int error;
+    if ((error = RND_queueLLHandleClear(queue, dtor))) {
+        RND_ERROR("RND_queueLLHandleClear returned error %d", error);
+        return error;
+    }
+    free(queue);
+    return 0;
+}
+
+size_t RND_queueLLHandleSize(const RND_QueueLLHandle *queue)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 0;
+    }
+    return queue->size;
+}
+
+int RND_queueLLIntrusiveInit(RND_QueueLLIntrusive *queue)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 1;
+    }
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->size = 0;
+    return 0;
+}
+
+int RND_queueLLIntrusivePush(RND_QueueLLIntrusive *queue, RND_QueueLLLink *link)
+{
+    if (!queue || !link) {
+        RND_ERROR("the queue or link does not exist");
+        return 1;
+    }
+    link->prev = queue->tail;
+    link->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = link;
+    } else {
+        queue->head = link;
+    }
+    queue->tail = link;
+    queue->size++;
+    return 0;
+}
+
+RND_QueueLLLink *RND_queueLLIntrusivePeek(const RND_QueueLLIntrusive *queue)
+{
+    return queue? queue->head : NULL;
+}
+
+RND_QueueLLLink *RND_queueLLIntrusivePop(RND_QueueLLIntrusive *queue)
+{
+    if (!queue || !queue->head) {
+        RND_WARN("the queue is already empty");
+        return NULL;
+    }
+    RND_QueueLLLink *ret = queue->head;
+    RND_queueLLIntrusiveRemove(queue, ret);
+    return ret;
+}
+
+int RND_queueLLIntrusiveRemove(RND_QueueLLIntrusive *queue, RND_QueueLLLink *link)
+{
+    if (!queue || !link) {
+        RND_ERROR("the queue or link does not exist");
+        return 1;
+    }
+    if (link->prev) {
+        link->prev->next = link->next;
+    } else {
+        queue->head = link->next;
+    }
+    if (link->next) {
+        link->next->prev = link->prev;
+    } else {
+        queue->tail = link->prev;
+    }
+    link->prev = link->next = NULL;
+    queue->size--;
+    return 0;
+}
+
+size_t RND_queueLLIntrusiveSize(const RND_QueueLLIntrusive *queue)
+{
+    if (!queue) {
+        RND_ERROR("the queue does not exist");
+        return 0;
+    }
+    return queue->size;
+}
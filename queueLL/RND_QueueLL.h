@@ -14,6 +14,21 @@
 #define RND_QUEUE_LL_H
 
 #include <stdlib.h>
+#include <stddef.h>
+
+/********************************************************
+ *                        MACROS                        *
+ ********************************************************/
+
+/** Returns the address of the struct an intrusive link is embedded in.
+ *
+ * @param[in] link A pointer to a @ref RND_QueueLLLink.
+ * @param[in] type The type of the struct which contains the link.
+ * @param[in] member The name of the link field inside @p type.
+ */
+#define RND_QUEUELL_ENTRY(link, type, member) \
+    ((type*)((char*)(link) - offsetof(type, member)))
+
 
 /********************************************************
  *                      STRUCTURES                      *
@@ -21,6 +36,9 @@
 
 /// @cond
 typedef struct RND_QueueLL RND_QueueLL;
+typedef struct RND_QueueLLHandle RND_QueueLLHandle;
+typedef struct RND_QueueLLLink RND_QueueLLLink;
+typedef struct RND_QueueLLIntrusive RND_QueueLLIntrusive;
 /// @endcond
 
 /** A FIFO queue structure for arbitrary data.
@@ -38,6 +56,66 @@ struct RND_QueueLL
     RND_QueueLL *next;
 };
 
+/** A FIFO queue handle with constant-time push and size.
+ *
+ * A bare @ref RND_QueueLL pointer only knows the front of the
+ * queue, so appending an element requires walking the whole
+ * list. This handle additionally remembers the last element
+ * and the number of elements, which makes @ref
+ * RND_queueLLHandlePush, @ref RND_queueLLHandlePop and @ref
+ * RND_queueLLHandleSize all O(1).
+ *
+ * The elements are ordinary @ref RND_QueueLL structs, so
+ * functions such as @ref RND_queueLLMap or @ref RND_queueLLPrint
+ * can still be used on @c &handle->head, as long as they
+ * don't add or remove any elements.
+ */
+struct RND_QueueLLHandle
+{
+    /// The front element of the queue (@c NULL if empty).
+    RND_QueueLL *head;
+    /// The last element of the queue (@c NULL if empty).
+    RND_QueueLL *tail;
+    /// The number of elements in the queue.
+    size_t size;
+};
+
+/** A link field to be embedded in user structs.
+ *
+ * To make a struct storable in a @ref RND_QueueLLIntrusive,
+ * give it a member of this type and pass that member's address
+ * to the queue functions. Use @ref RND_QUEUELL_ENTRY to get
+ * back from a link to the struct containing it.
+ *
+ * A link can only belong to one queue at a time.
+ */
+struct RND_QueueLLLink
+{
+    /// The link closer to the front (@c NULL for the front one).
+    RND_QueueLLLink *prev;
+    /// The link closer to the back (@c NULL for the last one).
+    RND_QueueLLLink *next;
+};
+
+/** An intrusive FIFO queue.
+ *
+ * Instead of allocating a @ref RND_QueueLL for every element,
+ * the queue is threaded through links embedded in the elements
+ * themselves, so enqueueing an existing object costs zero
+ * allocations and any element can be unlinked in constant time
+ * given its address. The queue never frees anything - it is up
+ * to the user to keep the elements alive while they're linked.
+ */
+struct RND_QueueLLIntrusive
+{
+    /// The front link of the queue (@c NULL if empty).
+    RND_QueueLLLink *head;
+    /// The last link of the queue (@c NULL if empty).
+    RND_QueueLLLink *tail;
+    /// The number of links in the queue.
+    size_t size;
+};
+
 
 /********************************************************
  *                      FUNCTIONS                       *
@@ -207,4 +285,154 @@ int RND_queueLLPrintMap(const RND_QueueLL *elem, size_t index);
  */
 int RND_queueLLDtorFree(const void *data);
 
+/** Allocates a new empty queue handle and returns its pointer.
+ *
+ * @returns
+ * - the new handle's address - success
+ * - @c NULL - insufficient memory
+ */
+RND_QueueLLHandle *RND_queueLLHandleCreate();
+
+/** Appends an element to the end of a queue in constant time.
+ *
+ * @param[inout] queue A pointer to the queue handle.
+ * @param[in] data The address of the data to be stored.
+ * @returns
+ * - 0 - success
+ * - 1 - insufficient memory
+ * - 2 - @p queue is @c NULL
+ */
+int RND_queueLLHandlePush(RND_QueueLLHandle *queue, const void *data);
+
+/** Returns a pointer to the front element of a queue.
+ *
+ * @param[in] queue A pointer to the queue handle.
+ * @returns
+ * - the front element's @ref RND_QueueLL::data - success
+ * - @c NULL - the queue is empty or @p queue is @c NULL
+ */
+void *RND_queueLLHandlePeek(const RND_QueueLLHandle *queue);
+
+/** Removes the front element from a queue.
+ *
+ * @param[inout] queue A pointer to the queue handle.
+ * @param[in] dtor A pointer to a function which intakes
+ * @ref RND_QueueLL::data and frees it, returning 0 for
+ * success and anything else for failure @b OR @c NULL
+ * if the data doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - the queue is empty or @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_queueLLHandlePop(RND_QueueLLHandle *queue, int (*dtor)(const void*));
+
+/** Removes an element from a queue by index.
+ *
+ * @param[inout] queue A pointer to the queue handle.
+ * @param[in] index The index of the element to remove (starting at front = 0).
+ * @param[in] dtor Same as in @ref RND_queueLLHandlePop.
+ * @returns
+ * - 0 - success
+ * - 1 - the queue is empty or @p queue is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ * - 3 - @p index out of range
+ */
+int RND_queueLLHandleRemove(RND_QueueLLHandle *queue, size_t index, int (*dtor)(const void*));
+
+/** Removes all elements from a queue.
+ *
+ * If some @p dtor call fails, the elements that were
+ * already removed stay removed and the handle remains
+ * consistent with the rest of the queue.
+ *
+ * @param[inout] queue A pointer to the queue handle.
+ * @param[in] dtor Same as in @ref RND_queueLLHandlePop.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0
+ * - 2 - @p queue is @c NULL
+ */
+int RND_queueLLHandleClear(RND_QueueLLHandle *queue, int (*dtor)(const void*));
+
+/** Frees all memory associated with a queue handle.
+ *
+ * First removes all elements with @ref RND_queueLLHandleClear,
+ * then frees the @ref RND_QueueLLHandle struct itself.
+ *
+ * @param[inout] queue A pointer to the queue handle.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_queueLLHandleClear.
+ */
+int RND_queueLLHandleDestroy(RND_QueueLLHandle *queue, int (*dtor)(const void*));
+
+/** Returns the number of elements in a queue in constant time.
+ *
+ * @param[in] queue A pointer to the queue handle.
+ * @returns
+ * - the size of the queue (@ref RND_QueueLLHandle::size) - success
+ * - 0 - if @p queue is @c NULL (or queue is empty)
+ */
+size_t RND_queueLLHandleSize(const RND_QueueLLHandle *queue);
+
+/** Initializes an empty intrusive queue.
+ *
+ * Intrusive queues do not own any memory, so there is no
+ * matching destroy function - the struct may live on the
+ * stack or inside some other struct.
+ *
+ * @param[out] queue A pointer to the queue to initialize.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue is @c NULL
+ */
+int RND_queueLLIntrusiveInit(RND_QueueLLIntrusive *queue);
+
+/** Appends a link to the end of an intrusive queue.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[inout] link A pointer to a link which isn't part of any queue.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue or @p link is @c NULL
+ */
+int RND_queueLLIntrusivePush(RND_QueueLLIntrusive *queue, RND_QueueLLLink *link);
+
+/** Returns the front link of an intrusive queue.
+ *
+ * @param[in] queue A pointer to the queue.
+ * @returns
+ * - the front link - success
+ * - @c NULL - the queue is empty or @p queue is @c NULL
+ */
+RND_QueueLLLink *RND_queueLLIntrusivePeek(const RND_QueueLLIntrusive *queue);
+
+/** Unlinks the front link of an intrusive queue and returns it.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @returns
+ * - the removed link - success
+ * - @c NULL - the queue is empty or @p queue is @c NULL
+ */
+RND_QueueLLLink *RND_queueLLIntrusivePop(RND_QueueLLIntrusive *queue);
+
+/** Unlinks any link from an intrusive queue in constant time.
+ *
+ * @param[inout] queue A pointer to the queue.
+ * @param[inout] link A pointer to a link which is part of @p queue.
+ * @returns
+ * - 0 - success
+ * - 1 - @p queue or @p link is @c NULL
+ */
+int RND_queueLLIntrusiveRemove(RND_QueueLLIntrusive *queue, RND_QueueLLLink *link);
+
+/** Returns the number of links in an intrusive queue.
+ *
+ * @param[in] queue A pointer to the queue.
+ * @returns
+ * - the size of the queue (@ref RND_QueueLLIntrusive::size) - success
+ * - 0 - if @p queue is @c NULL (or queue is empty)
+ */
+size_t RND_queueLLIntrusiveSize(const RND_QueueLLIntrusive *queue);
+
 #endif /* RND_QUEUE_LL_H */
@@ -13,6 +13,12 @@ int push(RND_QueueLL **queue, int val)
     return RND_queueLLPush(queue, new);
 }
 
+typedef struct Job
+{
+    int id;
+    RND_QueueLLLink link;
+} Job;
+
 int main(int argc, char **argv)
 {
     RND_QueueLL *test = RND_queueLLCreate();
@@ -39,5 +45,35 @@ int main(int argc, char **argv)
     RND_queueLLPop(&test, RND_queueLLDtorFree);
     RND_queueLLDestroy(&test, RND_queueLLDtorFree);
 
+    // A handle keeps track of the tail, so pushing long backlogs is O(1) per element
+    RND_QueueLLHandle *backlog = RND_queueLLHandleCreate();
+    for (int i = 0; i < 100000; i++) {
+        int *new;
+        if (!(new = (int*)malloc(sizeof(int)))) {
+            fprintf(stderr, "malloc error\n");
+            exit(1);
+        }
+        *new = i;
+        RND_queueLLHandlePush(backlog, new);
+    }
+    RND_queueLLHandleRemove(backlog, RND_queueLLHandleSize(backlog) - 1, RND_queueLLDtorFree);
+    RND_queueLLHandlePop(backlog, RND_queueLLDtorFree);
+    val = (int*)RND_queueLLHandlePeek(backlog);
+    printf("backlog front: %d, last: %d, size: %lu\n", *val, *(int*)backlog->tail->data, RND_queueLLHandleSize(backlog));
+    RND_queueLLHandleDestroy(backlog, RND_queueLLDtorFree);
+
+    // Intrusive queues thread through a link embedded in the elements
+    Job jobs[5];
+    RND_QueueLLIntrusive pending;
+    RND_queueLLIntrusiveInit(&pending);
+    for (int i = 0; i < 5; i++) {
+        jobs[i].id = i;
+        RND_queueLLIntrusivePush(&pending, &jobs[i].link);
+    }
+    RND_queueLLIntrusiveRemove(&pending, &jobs[4].link);
+    RND_QueueLLLink *front = RND_queueLLIntrusivePop(&pending);
+    printf("popped job %d, %lu left, last in line: %d\n", RND_QUEUELL_ENTRY(front, Job, link)->id,
+            RND_queueLLIntrusiveSize(&pending), RND_QUEUELL_ENTRY(pending.tail, Job, link)->id);
+
     return EXIT_SUCCESS;
 }
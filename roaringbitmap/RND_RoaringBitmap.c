@@ -0,0 +1,887 @@
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <RND_ErrMsg.h>
+#include "RND_RoaringBitmap.h"
+
+enum { RND_ROARING_BITMAP_AND, RND_ROARING_BITMAP_OR, RND_ROARING_BITMAP_XOR, RND_ROARING_BITMAP_ANDNOT };
+
+// Find the container with a given key, or the position to insert it at
+static size_t RND_roaringBitmapFind(const RND_RoaringBitmap *bitmap, uint16_t key, bool *found)
+{
+    size_t lo = 0, hi = bitmap->size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (bitmap->containers[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *found = (lo < bitmap->size && bitmap->containers[lo].key == key);
+    return lo;
+}
+
+static int RND_roaringBitmapReserve(RND_RoaringBitmap *bitmap, size_t capacity)
+{
+    if (capacity <= bitmap->capacity) {
+        return 0;
+    }
+    if (capacity < 2 * bitmap->capacity) {
+        capacity = 2 * bitmap->capacity;
+    }
+    RND_RoaringBitmapContainer *new;
+    if (!(new = (RND_RoaringBitmapContainer*)realloc(bitmap->containers, capacity * sizeof(RND_RoaringBitmapContainer)))) {
+        RND_ERROR("realloc");
+        return 2;
+    }
+    bitmap->containers = new;
+    bitmap->capacity   = capacity;
+    return 0;
+}
+
+// The index of the first of length sorted values not lower than value
+static uint32_t RND_roaringBitmapLowerBound(const uint16_t *values, uint32_t length, uint16_t value)
+{
+    uint32_t lo = 0, hi = length;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool RND_roaringBitmapContainerContains(const RND_RoaringBitmapContainer *container, uint16_t value)
+{
+    if (container->type == RND_ROARING_BITMAP_ARRAY) {
+        const uint16_t *values = container->data;
+        uint32_t i = RND_roaringBitmapLowerBound(values, container->length, value);
+        return i < container->length && values[i] == value;
+    } else if (container->type == RND_ROARING_BITMAP_BITSET) {
+        return (((const uint64_t*)container->data)[value / 64] >> (value % 64)) & 1;
+    }
+    // Find the last run starting at or before value
+    const uint16_t *runs = container->data;
+    uint32_t lo = 0, hi = container->length;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (runs[2 * mid] <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo > 0 && (uint16_t)(value - runs[2 * (lo - 1)]) <= runs[2 * (lo - 1) + 1];
+}
+
+// Set length bits of a bitset starting at start
+static void RND_roaringBitmapSetRange(uint64_t *words, uint32_t start, uint32_t length)
+{
+    uint32_t end = start + length;
+    while (start < end) {
+        uint32_t bits = 64 - start % 64;
+        if (bits > end - start) {
+            bits = end - start;
+        }
+        uint64_t mask = (bits == 64)? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1) << (start % 64);
+        words[start / 64] |= mask;
+        start += bits;
+    }
+}
+
+// Write the contents of a container as a bitset into words
+static void RND_roaringBitmapContainerBits(const RND_RoaringBitmapContainer *container, uint64_t *words)
+{
+    if (container->type == RND_ROARING_BITMAP_BITSET) {
+        memcpy(words, container->data, RND_ROARING_BITMAP_WORDS * sizeof(uint64_t));
+        return;
+    }
+    memset(words, 0, RND_ROARING_BITMAP_WORDS * sizeof(uint64_t));
+    const uint16_t *values = container->data;
+    if (container->type == RND_ROARING_BITMAP_ARRAY) {
+        for (uint32_t i = 0; i < container->length; i++) {
+            words[values[i] / 64] |= (uint64_t)1 << (values[i] % 64);
+        }
+    } else {
+        for (uint32_t i = 0; i < container->length; i++) {
+            RND_roaringBitmapSetRange(words, values[2 * i], (uint32_t)values[2 * i + 1] + 1);
+        }
+    }
+}
+
+/* Replace the contents of a container with a bitset holding cardinality
+ * values, stored as an array instead if it is sparse enough. The container
+ * takes over words. If there is no memory for the array, the bitset is
+ * kept as it is, which is just as correct.
+ */
+static void RND_roaringBitmapContainerSetBits(RND_RoaringBitmapContainer *container, uint64_t *words, uint32_t cardinality)
+{
+    if (container->data != words) {
+        free(container->data);
+    }
+    container->data        = words;
+    container->type        = RND_ROARING_BITMAP_BITSET;
+    container->cardinality = cardinality;
+    container->length      = container->capacity = 0;
+    if (cardinality > RND_ROARING_BITMAP_ARRAY_MAX) {
+        return;
+    }
+    uint16_t *values;
+    if (!(values = (uint16_t*)malloc((cardinality? cardinality : 1) * sizeof(uint16_t)))) {
+        return;
+    }
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < RND_ROARING_BITMAP_WORDS; i++) {
+        for (uint64_t bits = words[i]; bits; bits &= bits - 1) {
+            values[length++] = i * 64 + __builtin_ctzll(bits);
+        }
+    }
+    free(words);
+    container->data     = values;
+    container->type     = RND_ROARING_BITMAP_ARRAY;
+    container->length   = container->capacity = length;
+}
+
+// Turn a run container into an array or bitset one
+static int RND_roaringBitmapContainerUnrun(RND_RoaringBitmapContainer *container)
+{
+    uint64_t *words;
+    if (!(words = (uint64_t*)malloc(RND_ROARING_BITMAP_WORDS * sizeof(uint64_t)))) {
+        RND_ERROR("malloc");
+        return 2;
+    }
+    RND_roaringBitmapContainerBits(container, words);
+    RND_roaringBitmapContainerSetBits(container, words, container->cardinality);
+    return 0;
+}
+
+static int RND_roaringBitmapContainerCopy(const RND_RoaringBitmapContainer *container, RND_RoaringBitmapContainer *copy)
+{
+    size_t bytes = (container->type == RND_ROARING_BITMAP_BITSET)? RND_ROARING_BITMAP_WORDS * sizeof(uint64_t) :
+                   (container->type == RND_ROARING_BITMAP_RUN)? container->length * 2 * sizeof(uint16_t) :
+                   container->length * sizeof(uint16_t);
+    *copy = *container;
+    if (!(copy->data = malloc(bytes? bytes : 1))) {
+        RND_ERROR("malloc");
+        return 2;
+    }
+    memcpy(copy->data, container->data, bytes);
+    copy->capacity = copy->length;
+    return 0;
+}
+
+static int RND_roaringBitmapContainerAdd(RND_RoaringBitmapContainer *container, uint16_t value)
+{
+    if (container->type == RND_ROARING_BITMAP_RUN && RND_roaringBitmapContainerUnrun(container)) {
+        return 2;
+    }
+    if (container->type == RND_ROARING_BITMAP_BITSET) {
+        uint64_t *word = (uint64_t*)container->data + value / 64,
+                 mask  = (uint64_t)1 << (value % 64);
+        if (!(*word & mask)) {
+            *word |= mask;
+            container->cardinality++;
+        }
+        return 0;
+    }
+    uint16_t *values = container->data;
+    uint32_t i = RND_roaringBitmapLowerBound(values, container->length, value);
+    if (i < container->length && values[i] == value) {
+        return 0;
+    }
+    if (container->length == RND_ROARING_BITMAP_ARRAY_MAX) {
+        uint64_t *words;
+        if (!(words = (uint64_t*)malloc(RND_ROARING_BITMAP_WORDS * sizeof(uint64_t)))) {
+            RND_ERROR("malloc");
+            return 2;
+        }
+        RND_roaringBitmapContainerBits(container, words);
+        words[value / 64] |= (uint64_t)1 << (value % 64);
+        RND_roaringBitmapContainerSetBits(container, words, container->cardinality + 1);
+        return 0;
+    }
+    if (container->length == container->capacity) {
+        uint32_t capacity = 2 * container->capacity;
+        if (capacity > RND_ROARING_BITMAP_ARRAY_MAX) {
+            capacity = RND_ROARING_BITMAP_ARRAY_MAX;
+        }
+        if (!(values = (uint16_t*)realloc(container->data, capacity * sizeof(uint16_t)))) {
+            RND_ERROR("realloc");
+            return 2;
+        }
+        container->data     = values;
+        container->capacity = capacity;
+    }
+    memmove(values + i + 1, values + i, (container->length - i) * sizeof(uint16_t));
+    values[i] = value;
+    container->length++;
+    container->cardinality++;
+    return 0;
+}
+
+static int RND_roaringBitmapContainerRemove(RND_RoaringBitmapContainer *container, uint16_t value)
+{
+    if (container->type == RND_ROARING_BITMAP_RUN && RND_roaringBitmapContainerUnrun(container)) {
+        return 2;
+    }
+    if (container->type == RND_ROARING_BITMAP_BITSET) {
+        uint64_t *words = container->data,
+                 mask   = (uint64_t)1 << (value % 64);
+        if (words[value / 64] & mask) {
+            words[value / 64] &= ~mask;
+            if (--container->cardinality == RND_ROARING_BITMAP_ARRAY_MAX) {
+                RND_roaringBitmapContainerSetBits(container, words, container->cardinality);
+            }
+        }
+        return 0;
+    }
+    uint16_t *values = container->data;
+    uint32_t i = RND_roaringBitmapLowerBound(values, container->length, value);
+    if (i < container->length && values[i] == value) {
+        memmove(values + i, values + i + 1, (container->length - i - 1) * sizeof(uint16_t));
+        container->length--;
+        container->cardinality--;
+    }
+    return 0;
+}
+
+/* Merge two sorted arrays into out, keeping values found only in a,
+ * only in b or in both depending on op. Returns the output length.
+ */
+static uint32_t RND_roaringBitmapMerge(const uint16_t *a, uint32_t alen, const uint16_t *b, uint32_t blen, uint16_t *out, int op)
+{
+    bool only_a = (op != RND_ROARING_BITMAP_AND),
+         only_b = (op == RND_ROARING_BITMAP_OR || op == RND_ROARING_BITMAP_XOR),
+         both   = (op == RND_ROARING_BITMAP_AND || op == RND_ROARING_BITMAP_OR);
+    uint32_t i = 0, j = 0, n = 0;
+    while (i < alen && j < blen) {
+        if (a[i] < b[j]) {
+            if (only_a) {
+                out[n++] = a[i];
+            }
+            i++;
+        } else if (b[j] < a[i]) {
+            if (only_b) {
+                out[n++] = b[j];
+            }
+            j++;
+        } else {
+            if (both) {
+                out[n++] = a[i];
+            }
+            i++, j++;
+        }
+    }
+    if (only_a) {
+        memcpy(out + n, a + i, (alen - i) * sizeof(uint16_t));
+        n += alen - i;
+    }
+    if (only_b) {
+        memcpy(out + n, b + j, (blen - j) * sizeof(uint16_t));
+        n += blen - j;
+    }
+    return n;
+}
+
+// Make an array or bitset copy of a run container
+static int RND_roaringBitmapContainerExpand(const RND_RoaringBitmapContainer *container, RND_RoaringBitmapContainer *copy)
+{
+    uint64_t *words;
+    if (!(words = (uint64_t*)malloc(RND_ROARING_BITMAP_WORDS * sizeof(uint64_t)))) {
+        RND_ERROR("malloc");
+        return 2;
+    }
+    RND_roaringBitmapContainerBits(container, words);
+    copy->key  = container->key;
+    copy->data = NULL;
+    RND_roaringBitmapContainerSetBits(copy, words, container->cardinality);
+    return 0;
+}
+
+/* Combine two containers with the same key into a new one. Sorted arrays
+ * are merged, arrays are filtered through the other container when the
+ * result can only shrink, and everything else goes through a bitset.
+ */
+static int RND_roaringBitmapContainerOp(const RND_RoaringBitmapContainer *a, const RND_RoaringBitmapContainer *b, int op, RND_RoaringBitmapContainer *out)
+{
+    RND_RoaringBitmapContainer ta = { NULL }, tb = { NULL };
+    if (a->type == RND_ROARING_BITMAP_RUN) {
+        if (RND_roaringBitmapContainerExpand(a, &ta)) {
+            return 2;
+        }
+        a = &ta;
+    }
+    if (b->type == RND_ROARING_BITMAP_RUN) {
+        if (RND_roaringBitmapContainerExpand(b, &tb)) {
+            free(ta.data);
+            return 2;
+        }
+        b = &tb;
+    }
+    int error = 0;
+    out->key    = a->key;
+    out->data   = NULL;
+    out->length = out->capacity = 0;
+    bool merge  = (a->type == RND_ROARING_BITMAP_ARRAY && b->type == RND_ROARING_BITMAP_ARRAY),
+         filter = (a->type == RND_ROARING_BITMAP_ARRAY && (op == RND_ROARING_BITMAP_AND || op == RND_ROARING_BITMAP_ANDNOT))
+               || (b->type == RND_ROARING_BITMAP_ARRAY && op == RND_ROARING_BITMAP_AND);
+    if (merge || filter) {
+        // Intersections of sparse chunks are often empty, so only allocate once the result is known
+        uint16_t buffer[2 * RND_ROARING_BITMAP_ARRAY_MAX];
+        uint32_t length = 0;
+        if (merge) {
+            length = RND_roaringBitmapMerge(a->data, a->length, b->data, b->length, buffer, op);
+        } else {
+            const RND_RoaringBitmapContainer *array = (a->type == RND_ROARING_BITMAP_ARRAY)? a : b,
+                                             *other = (array == a)? b : a;
+            const uint16_t *values = array->data;
+            for (uint32_t i = 0; i < array->length; i++) {
+                if (RND_roaringBitmapContainerContains(other, values[i]) == (op == RND_ROARING_BITMAP_AND)) {
+                    buffer[length++] = values[i];
+                }
+            }
+        }
+        out->type        = RND_ROARING_BITMAP_ARRAY;
+        out->cardinality = out->length = out->capacity = length;
+        if (length > RND_ROARING_BITMAP_ARRAY_MAX) {
+            uint64_t *words;
+            if (!(words = (uint64_t*)calloc(RND_ROARING_BITMAP_WORDS, sizeof(uint64_t)))) {
+                RND_ERROR("calloc");
+                error = 2;
+            } else {
+                for (uint32_t i = 0; i < length; i++) {
+                    words[buffer[i] / 64] |= (uint64_t)1 << (buffer[i] % 64);
+                }
+                RND_roaringBitmapContainerSetBits(out, words, length);
+            }
+        } else if (length) {
+            if (!(out->data = malloc(length * sizeof(uint16_t)))) {
+                RND_ERROR("malloc");
+                error = 2;
+            } else {
+                memcpy(out->data, buffer, length * sizeof(uint16_t));
+            }
+        }
+    } else {
+        uint64_t *words;
+        if (!(words = (uint64_t*)malloc(RND_ROARING_BITMAP_WORDS * sizeof(uint64_t)))) {
+            RND_ERROR("malloc");
+            error = 2;
+        } else {
+            RND_roaringBitmapContainerBits(a, words);
+            if (b->type == RND_ROARING_BITMAP_BITSET) {
+                const uint64_t *other = b->data;
+                for (uint32_t i = 0; i < RND_ROARING_BITMAP_WORDS; i++) {
+                    switch (op) {
+                        case RND_ROARING_BITMAP_AND:    words[i] &= other[i];  break;
+                        case RND_ROARING_BITMAP_OR:     words[i] |= other[i];  break;
+                        case RND_ROARING_BITMAP_XOR:    words[i] ^= other[i];  break;
+                        case RND_ROARING_BITMAP_ANDNOT: words[i] &= ~other[i]; break;
+                    }
+                }
+            } else {
+                const uint16_t *values = b->data;
+                for (uint32_t i = 0; i < b->length; i++) {
+                    uint64_t mask = (uint64_t)1 << (values[i] % 64);
+                    switch (op) {
+                        case RND_ROARING_BITMAP_OR:     words[values[i] / 64] |= mask;  break;
+                        case RND_ROARING_BITMAP_XOR:    words[values[i] / 64] ^= mask;  break;
+                        case RND_ROARING_BITMAP_ANDNOT: words[values[i] / 64] &= ~mask; break;
+                    }
+                }
+            }
+            uint32_t cardinality = 0;
+            for (uint32_t i = 0; i < RND_ROARING_BITMAP_WORDS; i++) {
+                cardinality += __builtin_popcountll(words[i]);
+            }
+            RND_roaringBitmapContainerSetBits(out, words, cardinality);
+        }
+    }
+    free(ta.data);
+    free(tb.data);
+    return error;
+}
+
+/* Build the new list of containers of dest next to the old one, so that
+ * dest can be left untouched if memory runs out. Containers of dest that
+ * are kept as they are get moved over, all others are freed at the end.
+ */
+static int RND_roaringBitmapApply(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src, int op)
+{
+    size_t capacity = dest->size + src->size;
+    RND_RoaringBitmapContainer *out;
+    bool *fresh, *moved;
+    out   = (RND_RoaringBitmapContainer*)malloc((capacity? capacity : 1) * sizeof(RND_RoaringBitmapContainer));
+    fresh = (bool*)malloc(capacity? capacity : 1);
+    moved = (bool*)calloc(dest->size? dest->size : 1, sizeof(bool));
+    if (!out || !fresh || !moved) {
+        RND_ERROR("malloc");
+        free(out);
+        free(fresh);
+        free(moved);
+        return 2;
+    }
+    size_t i = 0, j = 0, n = 0;
+    while (i < dest->size || j < src->size) {
+        RND_RoaringBitmapContainer *a = (i < dest->size)? dest->containers + i : NULL;
+        const RND_RoaringBitmapContainer *b = (j < src->size)? src->containers + j : NULL;
+        if (!b || (a && a->key < b->key)) {
+            if (op != RND_ROARING_BITMAP_AND) {
+                out[n] = *a;
+                fresh[n++] = false;
+                moved[i] = true;
+            }
+            i++;
+        } else if (!a || b->key < a->key) {
+            if (op == RND_ROARING_BITMAP_OR || op == RND_ROARING_BITMAP_XOR) {
+                if (RND_roaringBitmapContainerCopy(b, out + n)) {
+                    break;
+                }
+                fresh[n++] = true;
+            }
+            j++;
+        } else {
+            if (RND_roaringBitmapContainerOp(a, b, op, out + n)) {
+                break;
+            }
+            if (out[n].cardinality) {
+                fresh[n++] = true;
+            } else {
+                free(out[n].data);
+            }
+            i++, j++;
+        }
+    }
+    if (i < dest->size || j < src->size) {
+        for (size_t k = 0; k < n; k++) {
+            if (fresh[k]) {
+                free(out[k].data);
+            }
+        }
+        free(out);
+        free(fresh);
+        free(moved);
+        return 2;
+    }
+    for (size_t k = 0; k < dest->size; k++) {
+        if (!moved[k]) {
+            free(dest->containers[k].data);
+        }
+    }
+    free(dest->containers);
+    dest->containers = out;
+    dest->size       = n;
+    dest->capacity   = capacity;
+    free(fresh);
+    free(moved);
+    return 0;
+}
+
+RND_RoaringBitmap *RND_roaringBitmapCreate()
+{
+    RND_RoaringBitmap *bitmap;
+    if (!(bitmap = (RND_RoaringBitmap*)malloc(sizeof(RND_RoaringBitmap)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    bitmap->containers = NULL;
+    bitmap->size       = 0;
+    bitmap->capacity   = 0;
+    return bitmap;
+}
+
+int RND_roaringBitmapAdd(RND_RoaringBitmap *bitmap, uint32_t value)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return 1;
+    }
+    bool found;
+    size_t i = RND_roaringBitmapFind(bitmap, value >> 16, &found);
+    if (!found) {
+        uint16_t *values;
+        if (RND_roaringBitmapReserve(bitmap, bitmap->size + 1)) {
+            return 2;
+        }
+        if (!(values = (uint16_t*)malloc(4 * sizeof(uint16_t)))) {
+            RND_ERROR("malloc");
+            return 2;
+        }
+        RND_RoaringBitmapContainer *container = bitmap->containers + i;
+        memmove(container + 1, container, (bitmap->size - i) * sizeof(RND_RoaringBitmapContainer));
+        bitmap->size++;
+        container->data        = values;
+        container->cardinality = 0;
+        container->length      = 0;
+        container->capacity    = 4;
+        container->key         = value >> 16;
+        container->type        = RND_ROARING_BITMAP_ARRAY;
+    }
+    return RND_roaringBitmapContainerAdd(bitmap->containers + i, value & 0xffff);
+}
+
+int RND_roaringBitmapRemove(RND_RoaringBitmap *bitmap, uint32_t value)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return 1;
+    }
+    bool found;
+    size_t i = RND_roaringBitmapFind(bitmap, value >> 16, &found);
+    if (!found) {
+        return 0;
+    }
+    RND_RoaringBitmapContainer *container = bitmap->containers + i;
+    if (RND_roaringBitmapContainerRemove(container, value & 0xffff)) {
+        return 2;
+    }
+    if (!container->cardinality) {
+        free(container->data);
+        memmove(container, container + 1, (bitmap->size - i - 1) * sizeof(RND_RoaringBitmapContainer));
+        bitmap->size--;
+    }
+    return 0;
+}
+
+bool RND_roaringBitmapContains(const RND_RoaringBitmap *bitmap, uint32_t value)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return false;
+    }
+    bool found;
+    size_t i = RND_roaringBitmapFind(bitmap, value >> 16, &found);
+    return found && RND_roaringBitmapContainerContains(bitmap->containers + i, value & 0xffff);
+}
+
+uint64_t RND_roaringBitmapCount(const RND_RoaringBitmap *bitmap)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return 0;
+    }
+    uint64_t count = 0;
+    for (size_t i = 0; i < bitmap->size; i++) {
+        count += bitmap->containers[i].cardinality;
+    }
+    return count;
+}
+
+int RND_roaringBitmapAnd(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src)
+{
+    if (!dest) {
+        RND_ERROR("the destination bitmap does not exist");
+        return 1;
+    }
+    if (!src) {
+        return 0;
+    }
+    return RND_roaringBitmapApply(dest, src, RND_ROARING_BITMAP_AND);
+}
+
+int RND_roaringBitmapOr(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src)
+{
+    if (!dest) {
+        RND_ERROR("the destination bitmap does not exist");
+        return 1;
+    }
+    if (!src) {
+        return 0;
+    }
+    return RND_roaringBitmapApply(dest, src, RND_ROARING_BITMAP_OR);
+}
+
+int RND_roaringBitmapXor(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src)
+{
+    if (!dest) {
+        RND_ERROR("the destination bitmap does not exist");
+        return 1;
+    }
+    if (!src) {
+        return 0;
+    }
+    return RND_roaringBitmapApply(dest, src, RND_ROARING_BITMAP_XOR);
+}
+
+int RND_roaringBitmapAndNot(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src)
+{
+    if (!dest) {
+        RND_ERROR("the destination bitmap does not exist");
+        return 1;
+    }
+    if (!src) {
+        return 0;
+    }
+    return RND_roaringBitmapApply(dest, src, RND_ROARING_BITMAP_ANDNOT);
+}
+
+// Count the runs of consecutive values in a container
+static uint32_t RND_roaringBitmapContainerRuns(const RND_RoaringBitmapContainer *container)
+{
+    if (container->type == RND_ROARING_BITMAP_RUN) {
+        return container->length;
+    }
+    uint32_t runs = 0;
+    if (container->type == RND_ROARING_BITMAP_ARRAY) {
+        const uint16_t *values = container->data;
+        for (uint32_t i = 0; i < container->length; i++) {
+            runs += (i == 0 || values[i] != values[i - 1] + 1);
+        }
+    } else {
+        const uint64_t *words = container->data;
+        uint64_t carry = 0;
+        for (uint32_t i = 0; i < RND_ROARING_BITMAP_WORDS; i++) {
+            // A run starts at every set bit whose lower neighbour is clear
+            runs += __builtin_popcountll(words[i] & ~((words[i] << 1) | carry));
+            carry = words[i] >> 63;
+        }
+    }
+    return runs;
+}
+
+static int RND_roaringBitmapContainerToRuns(RND_RoaringBitmapContainer *container, uint32_t count)
+{
+    uint16_t *runs;
+    if (!(runs = (uint16_t*)malloc(2 * count * sizeof(uint16_t)))) {
+        RND_ERROR("malloc");
+        return 2;
+    }
+    uint32_t n = 0;
+    int32_t last = -2;
+    if (container->type == RND_ROARING_BITMAP_ARRAY) {
+        const uint16_t *values = container->data;
+        for (uint32_t i = 0; i < container->length; last = values[i++]) {
+            if (values[i] == last + 1) {
+                runs[2 * n - 1]++;
+            } else {
+                runs[2 * n] = values[i];
+                runs[2 * n + 1] = 0;
+                n++;
+            }
+        }
+    } else {
+        const uint64_t *words = container->data;
+        for (uint32_t i = 0; i < RND_ROARING_BITMAP_WORDS; i++) {
+            for (uint64_t bits = words[i]; bits; bits &= bits - 1) {
+                int32_t value = i * 64 + __builtin_ctzll(bits);
+                if (value == last + 1) {
+                    runs[2 * n - 1]++;
+                } else {
+                    runs[2 * n] = value;
+                    runs[2 * n + 1] = 0;
+                    n++;
+                }
+                last = value;
+            }
+        }
+    }
+    free(container->data);
+    container->data     = runs;
+    container->type     = RND_ROARING_BITMAP_RUN;
+    container->length   = container->capacity = n;
+    return 0;
+}
+
+int RND_roaringBitmapOptimize(RND_RoaringBitmap *bitmap)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return 1;
+    }
+    int error = 0;
+    for (size_t i = 0; i < bitmap->size; i++) {
+        RND_RoaringBitmapContainer *container = bitmap->containers + i;
+        uint32_t runs = RND_roaringBitmapContainerRuns(container);
+        size_t run_bytes   = 2 * runs * sizeof(uint16_t),
+               other_bytes = (container->cardinality <= RND_ROARING_BITMAP_ARRAY_MAX)?
+                             container->cardinality * sizeof(uint16_t) : RND_ROARING_BITMAP_WORDS * sizeof(uint64_t);
+        if (run_bytes < other_bytes) {
+            if (container->type != RND_ROARING_BITMAP_RUN && RND_roaringBitmapContainerToRuns(container, runs)) {
+                error = 2;
+            }
+        } else if (container->type == RND_ROARING_BITMAP_RUN && RND_roaringBitmapContainerUnrun(container)) {
+            error = 2;
+        }
+    }
+    return error;
+}
+
+int RND_roaringBitmapMap(const RND_RoaringBitmap *bitmap, int (*map)(uint32_t, void*), void *arg)
+{
+    if (!bitmap || !map) {
+        RND_WARN("bitmap or map function empty");
+        return 1;
+    }
+    for (size_t i = 0; i < bitmap->size; i++) {
+        const RND_RoaringBitmapContainer *container = bitmap->containers + i;
+        uint32_t base = (uint32_t)container->key << 16;
+        const uint16_t *values = container->data;
+        int error = 0;
+        uint32_t value = 0;
+        if (container->type == RND_ROARING_BITMAP_ARRAY) {
+            for (uint32_t j = 0; j < container->length && !error; j++) {
+                error = map(value = base | values[j], arg);
+            }
+        } else if (container->type == RND_ROARING_BITMAP_BITSET) {
+            const uint64_t *words = container->data;
+            for (uint32_t j = 0; j < RND_ROARING_BITMAP_WORDS && !error; j++) {
+                for (uint64_t bits = words[j]; bits && !error; bits &= bits - 1) {
+                    error = map(value = base | (j * 64 + __builtin_ctzll(bits)), arg);
+                }
+            }
+        } else {
+            for (uint32_t j = 0; j < container->length && !error; j++) {
+                for (uint32_t k = 0; k <= values[2 * j + 1] && !error; k++) {
+                    error = map(value = base | (values[2 * j] + k), arg);
+                }
+            }
+        }
+        if (error) {
+            RND_ERROR("map function returned %d for value %u", error, value);
+            return 2;
+        }
+    }
+    return 0;
+}
+
+RND_RoaringBitmap *RND_roaringBitmapFromBitArray(const RND_BitArray *bitarray)
+{
+    if (!bitarray) {
+        RND_ERROR("the bitarray does not exist");
+        return NULL;
+    }
+    RND_RoaringBitmap *bitmap;
+    if (!(bitmap = RND_roaringBitmapCreate())) {
+        RND_ERROR("RND_roaringBitmapCreate returned NULL");
+        return NULL;
+    }
+    size_t size  = (bitarray->size > (size_t)UINT32_MAX)? (size_t)UINT32_MAX + 1 : bitarray->size,
+           words = (size + 63) / 64;
+    for (size_t first = 0; first < words; first += RND_ROARING_BITMAP_WORDS) {
+        size_t count = (words - first < RND_ROARING_BITMAP_WORDS)? words - first : RND_ROARING_BITMAP_WORDS;
+        uint32_t cardinality = 0;
+        for (size_t i = first; i < first + count; i++) {
+            cardinality += __builtin_popcountll(bitarray->bits[i]);
+        }
+        if (!cardinality) {
+            continue;
+        }
+        uint64_t *chunk;
+        if (RND_roaringBitmapReserve(bitmap, bitmap->size + 1) ||
+                !(chunk = (uint64_t*)calloc(RND_ROARING_BITMAP_WORDS, sizeof(uint64_t)))) {
+            RND_ERROR("insufficient memory");
+            RND_roaringBitmapDestroy(bitmap);
+            return NULL;
+        }
+        memcpy(chunk, bitarray->bits + first, count * sizeof(uint64_t));
+        RND_RoaringBitmapContainer *container = bitmap->containers + bitmap->size++;
+        container->data = NULL;
+        container->key  = first / RND_ROARING_BITMAP_WORDS;
+        RND_roaringBitmapContainerSetBits(container, chunk, cardinality);
+    }
+    return bitmap;
+}
+
+RND_BitArray *RND_roaringBitmapToBitArray(const RND_RoaringBitmap *bitmap)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return NULL;
+    }
+    size_t size = 0;
+    if (bitmap->size) {
+        const RND_RoaringBitmapContainer *last = bitmap->containers + bitmap->size - 1;
+        const uint16_t *values = last->data;
+        uint32_t max = 0;
+        if (last->type == RND_ROARING_BITMAP_ARRAY) {
+            max = values[last->length - 1];
+        } else if (last->type == RND_ROARING_BITMAP_RUN) {
+            max = values[2 * last->length - 2] + values[2 * last->length - 1];
+        } else {
+            const uint64_t *words = last->data;
+            uint32_t i = RND_ROARING_BITMAP_WORDS;
+            while (!words[--i]);
+            max = i * 64 + 63 - __builtin_clzll(words[i]);
+        }
+        size = ((size_t)last->key << 16) + max + 1;
+    }
+    RND_BitArray *bitarray;
+    if (!(bitarray = RND_bitArrayCreate(size))) {
+        RND_ERROR("RND_bitArrayCreate returned NULL");
+        return NULL;
+    }
+    size_t words = (size + 63) / 64;
+    for (size_t i = 0; i < bitmap->size; i++) {
+        const RND_RoaringBitmapContainer *container = bitmap->containers + i;
+        size_t base = (size_t)container->key << 16;
+        const uint16_t *values = container->data;
+        if (container->type == RND_ROARING_BITMAP_ARRAY) {
+            for (uint32_t j = 0; j < container->length; j++) {
+                bitarray->bits[(base + values[j]) / 64] |= (uint64_t)1 << (values[j] % 64);
+            }
+        } else if (container->type == RND_ROARING_BITMAP_RUN) {
+            for (uint32_t j = 0; j < container->length; j++) {
+                RND_bitArraySetRange(bitarray, base + values[2 * j], (size_t)values[2 * j + 1] + 1);
+            }
+        } else {
+            size_t first = base / 64,
+                   count = (words - first < RND_ROARING_BITMAP_WORDS)? words - first : RND_ROARING_BITMAP_WORDS;
+            memcpy(bitarray->bits + first, container->data, count * sizeof(uint64_t));
+        }
+    }
+    return bitarray;
+}
+
+RND_RoaringBitmap *RND_roaringBitmapCopy(const RND_RoaringBitmap *bitmap)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return NULL;
+    }
+    RND_RoaringBitmap *new;
+    if (!(new = RND_roaringBitmapCreate())) {
+        RND_ERROR("RND_roaringBitmapCreate returned NULL");
+        return NULL;
+    }
+    if (RND_roaringBitmapReserve(new, bitmap->size)) {
+        RND_roaringBitmapDestroy(new);
+        return NULL;
+    }
+    for (size_t i = 0; i < bitmap->size; i++) {
+        if (RND_roaringBitmapContainerCopy(bitmap->containers + i, new->containers + i)) {
+            RND_roaringBitmapDestroy(new);
+            return NULL;
+        }
+        new->size++;
+    }
+    return new;
+}
+
+int RND_roaringBitmapClear(RND_RoaringBitmap *bitmap)
+{
+    if (!bitmap) {
+        RND_ERROR("the bitmap does not exist");
+        return 1;
+    }
+    for (size_t i = 0; i < bitmap->size; i++) {
+        free(bitmap->containers[i].data);
+    }
+    bitmap->size = 0;
+    return 0;
+}
+
+int RND_roaringBitmapDestroy(RND_RoaringBitmap *bitmap)
+{
+    if (!bitmap) {
+        RND_WARN("the bitmap does not exist");
+        return 1;
+    }
+    RND_roaringBitmapClear(bitmap);
+    free(bitmap->containers);
+    free(bitmap);
+    return 0;
+}
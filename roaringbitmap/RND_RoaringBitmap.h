@@ -0,0 +1,296 @@
+/** @file
+ * The header file of the RND_RoaringBitmap library.
+ *
+ * A roaring bitmap is a compressed set of 32-bit unsigned integers.
+ * The value range is split into chunks of 65536 values, and every
+ * non-empty chunk is stored in whichever of three containers fits
+ * it best: a sorted array for sparse chunks, a plain bitset for
+ * dense chunks, or a list of runs for chunks made of long intervals.
+ * Sets of IDs spread across the whole 32-bit range thus take memory
+ * proportional to their size, while boolean operations between them
+ * still work on whole chunks at a time.
+ *
+ * @example roaringbitmap/example.c
+ * Here's an example usage of the RND_RoaringBitmap library.
+ */
+
+#ifndef RND_ROARING_BITMAP_H
+#define RND_ROARING_BITMAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <RND_BitArray.h>
+
+/********************************************************
+ *                      CONSTANTS                       *
+ ********************************************************/
+
+/// Container type: a sorted array of the values.
+#define RND_ROARING_BITMAP_ARRAY 0
+
+/// Container type: a bitset with one bit per possible value.
+#define RND_ROARING_BITMAP_BITSET 1
+
+/// Container type: a sorted list of runs of consecutive values.
+#define RND_ROARING_BITMAP_RUN 2
+
+/** The largest number of values stored in an array container.
+ *
+ * Above this, a sorted array of 16-bit values would take more memory
+ * than a bitset of all 65536 values.
+ */
+#define RND_ROARING_BITMAP_ARRAY_MAX 4096
+
+/// The number of 64-bit words in a bitset container.
+#define RND_ROARING_BITMAP_WORDS (65536 / 64)
+
+/********************************************************
+ *                     STRUCTURES                       *
+ ********************************************************/
+
+/// @cond
+typedef struct RND_RoaringBitmap RND_RoaringBitmap;
+typedef struct RND_RoaringBitmapContainer RND_RoaringBitmapContainer;
+/// @endcond
+
+/** The values of a @ref RND_RoaringBitmap sharing the same upper 16 bits.
+ *
+ * Only the lower 16 bits of each value are stored, in one of these forms:
+ * - @ref RND_ROARING_BITMAP_ARRAY - @ref data is a sorted array of
+ *   @ref length @c uint16_t values (at most @ref RND_ROARING_BITMAP_ARRAY_MAX)
+ * - @ref RND_ROARING_BITMAP_BITSET - @ref data is an array of
+ *   @ref RND_ROARING_BITMAP_WORDS @c uint64_t words, where bit @c (v % 64)
+ *   of word @c (v / 64) is set if the value @c v is present
+ * - @ref RND_ROARING_BITMAP_RUN - @ref data is a sorted array of
+ *   @ref length pairs of @c uint16_t, each holding the first value
+ *   of a run and the run's length minus 1
+ */
+struct RND_RoaringBitmapContainer
+{
+    /// The contents of the container (see above).
+    void *data;
+    /// The number of values in the container (1 to 65536).
+    uint32_t cardinality;
+    /// The number of values (array) or runs (run) in @ref data.
+    uint32_t length;
+    /// The number of values (array) or runs (run) @ref data has room for.
+    uint32_t capacity;
+    /// The upper 16 bits of all values in the container.
+    uint16_t key;
+    /// The type of the container.
+    uint8_t type;
+};
+
+/** A compressed set of 32-bit unsigned integers.
+ *
+ * The bitmap holds one container per non-empty chunk of 65536
+ * values, sorted by @ref RND_RoaringBitmapContainer::key.
+ * Adding and removing values switches containers between arrays
+ * and bitsets as needed. Run containers are only made by
+ * @ref RND_roaringBitmapOptimize.
+ */
+struct RND_RoaringBitmap
+{
+    /// The containers sorted by key.
+    RND_RoaringBitmapContainer *containers;
+    /// The number of containers.
+    size_t size;
+    /// The number of containers @ref containers has room for.
+    size_t capacity;
+};
+
+/********************************************************
+ *                      FUNCTIONS                       *
+ ********************************************************/
+
+/** Allocates a new empty roaring bitmap and returns its pointer.
+ *
+ * @returns
+ * - the new bitmap's address - success
+ * - @c NULL - insufficient memory
+ */
+RND_RoaringBitmap *RND_roaringBitmapCreate();
+
+/** Adds a value to a roaring bitmap.
+ *
+ * Adding a value that is already present does nothing.
+ *
+ * @param[inout] bitmap A pointer to the bitmap.
+ * @param[in] value The value to add.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitmap is a NULL-pointer
+ * - 2 - insufficient memory
+ */
+int  RND_roaringBitmapAdd(RND_RoaringBitmap *bitmap, uint32_t value);
+
+/** Removes a value from a roaring bitmap.
+ *
+ * Removing a value that is not present does nothing.
+ *
+ * @param[inout] bitmap A pointer to the bitmap.
+ * @param[in] value The value to remove.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitmap is a NULL-pointer
+ * - 2 - insufficient memory
+ */
+int  RND_roaringBitmapRemove(RND_RoaringBitmap *bitmap, uint32_t value);
+
+/** Checks whether a value is present in a roaring bitmap.
+ *
+ * @param[in] bitmap A pointer to the bitmap.
+ * @param[in] value The value to look for.
+ * @returns
+ * - @c true - @p value is present
+ * - @c false - @p value is not present or @p bitmap is a NULL-pointer
+ */
+bool RND_roaringBitmapContains(const RND_RoaringBitmap *bitmap, uint32_t value);
+
+/** Returns the number of values in a roaring bitmap.
+ *
+ * @param[in] bitmap A pointer to the bitmap.
+ * @returns
+ * - the number of values - success
+ * - 0 - @p bitmap is a NULL-pointer (or bitmap is empty)
+ */
+uint64_t RND_roaringBitmapCount(const RND_RoaringBitmap *bitmap);
+
+/** Performs the intersection of two roaring bitmaps.
+ *
+ * The result overwrites the contents of @p dest. Only chunks
+ * present in both bitmaps are visited.
+ *
+ * @param[inout] dest A pointer to the bitmap for storing the result.
+ * @param[in] src A pointer to any other bitmap (if @c NULL, nothing happens).
+ * @returns
+ * - 0 - success
+ * - 1 - @p dest is a NULL-pointer
+ * - 2 - insufficient memory (@p dest is left unchanged)
+ */
+int  RND_roaringBitmapAnd(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src);
+
+/** Performs the union of two roaring bitmaps.
+ *
+ * The result overwrites the contents of @p dest.
+ *
+ * @param[inout] dest A pointer to the bitmap for storing the result.
+ * @param[in] src A pointer to any other bitmap (if @c NULL, nothing happens).
+ * @returns
+ * - 0 - success
+ * - 1 - @p dest is a NULL-pointer
+ * - 2 - insufficient memory (@p dest is left unchanged)
+ */
+int  RND_roaringBitmapOr(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src);
+
+/** Performs the symmetric difference of two roaring bitmaps.
+ *
+ * The result overwrites the contents of @p dest.
+ *
+ * @param[inout] dest A pointer to the bitmap for storing the result.
+ * @param[in] src A pointer to any other bitmap (if @c NULL, nothing happens).
+ * @returns
+ * - 0 - success
+ * - 1 - @p dest is a NULL-pointer
+ * - 2 - insufficient memory (@p dest is left unchanged)
+ */
+int  RND_roaringBitmapXor(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src);
+
+/** Removes all values of one roaring bitmap from another.
+ *
+ * The result overwrites the contents of @p dest.
+ *
+ * @param[inout] dest A pointer to the bitmap for storing the result.
+ * @param[in] src A pointer to any other bitmap (if @c NULL, nothing happens).
+ * @returns
+ * - 0 - success
+ * - 1 - @p dest is a NULL-pointer
+ * - 2 - insufficient memory (@p dest is left unchanged)
+ */
+int  RND_roaringBitmapAndNot(RND_RoaringBitmap *dest, const RND_RoaringBitmap *src);
+
+/** Converts containers to runs wherever that saves memory.
+ *
+ * This is worth calling once a bitmap holding long intervals
+ * of consecutive values has been filled. Any later modification
+ * of a run container turns it back into an array or a bitset.
+ *
+ * @param[inout] bitmap A pointer to the bitmap.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitmap is a NULL-pointer
+ * - 2 - insufficient memory (some containers may be left unconverted)
+ */
+int  RND_roaringBitmapOptimize(RND_RoaringBitmap *bitmap);
+
+/** Passes each value of a roaring bitmap to a custom function.
+ *
+ * The values are visited in ascending order.
+ *
+ * @param[in] bitmap A pointer to the bitmap.
+ * @param[in] map A pointer to a function which intakes a value
+ * (@c uint32_t) and @p arg. The function must return 0
+ * for success, and any other value for failure.
+ * @param[in] arg Any pointer, passed directly to @p map.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitmap or @p map is @c NULL
+ * - 2 - some @p map returned non-0 (this means that
+ *   mapping the bitmap was interrupted)
+ */
+int  RND_roaringBitmapMap(const RND_RoaringBitmap *bitmap, int (*map)(uint32_t, void*), void *arg);
+
+/** Creates a roaring bitmap holding the indices of all set bits of a bitarray.
+ *
+ * The bitarray is read 65536 bits at a time, straight into bitset
+ * containers which are then shrunk to arrays if they are sparse.
+ * Bits with indices above @c UINT32_MAX are ignored.
+ *
+ * @param[in] bitarray A pointer to the bitarray.
+ * @returns
+ * - the new bitmap's address - success
+ * - @c NULL - insufficient memory @b OR @p bitarray is a NULL-pointer
+ */
+RND_RoaringBitmap *RND_roaringBitmapFromBitArray(const RND_BitArray *bitarray);
+
+/** Creates a bitarray with the bits set at the values of a roaring bitmap.
+ *
+ * The size of the new bitarray is one more than the largest
+ * value in @p bitmap, or 0 if @p bitmap is empty.
+ *
+ * @param[in] bitmap A pointer to the bitmap.
+ * @returns
+ * - the new bitarray's address - success
+ * - @c NULL - insufficient memory @b OR @p bitmap is a NULL-pointer
+ */
+RND_BitArray *RND_roaringBitmapToBitArray(const RND_RoaringBitmap *bitmap);
+
+/** Creates a deep copy of a roaring bitmap.
+ *
+ * @param[in] bitmap A pointer to the bitmap.
+ * @returns
+ * - the new bitmap's address - success
+ * - @c NULL - insufficient memory @b OR @p bitmap is a NULL-pointer
+ */
+RND_RoaringBitmap *RND_roaringBitmapCopy(const RND_RoaringBitmap *bitmap);
+
+/** Removes all values from a roaring bitmap.
+ *
+ * @param[inout] bitmap A pointer to the bitmap.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitmap is a NULL-pointer
+ */
+int  RND_roaringBitmapClear(RND_RoaringBitmap *bitmap);
+
+/** Frees all memory associated with a roaring bitmap.
+ *
+ * @param[in] bitmap A pointer to the bitmap.
+ * @returns
+ * - 0 - success
+ * - 1 - @p bitmap is a NULL-pointer
+ */
+int  RND_roaringBitmapDestroy(RND_RoaringBitmap *bitmap);
+
+#endif /* RND_ROARING_BITMAP_H */
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <string.h>
+#include <RND_RoaringBitmap.h>
+#include <RND_Utils.h>
+
+#define COUNT   1000000
+#define REPEATS 10
+
+/* Intersects two sets of COUNT 32-bit IDs, stored once as sorted arrays
+ * (merged with a linear scan) and once as roaring bitmaps. The IDs are
+ * either spread over the whole 32-bit range, which leaves a few values
+ * in each chunk, or packed into the lowest 2^23 values, which fills
+ * every chunk densely. The memory used by both representations and the
+ * size of the intersection are reported as well. The roaring intersection
+ * includes copying the first bitmap, since RND_roaringBitmapAnd works in place.
+ */
+
+uint32_t a[COUNT], b[COUNT], out[COUNT];
+
+int compare(const void *x, const void *y)
+{
+    uint32_t u = *(const uint32_t*)x, v = *(const uint32_t*)y;
+    return (u > v) - (u < v);
+}
+
+uint32_t randomId(uint32_t range)
+{
+    uint32_t id = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    return range? id % range : id;
+}
+
+// Sort and remove duplicates, returning the new length
+size_t prepare(uint32_t *ids, size_t count)
+{
+    qsort(ids, count, sizeof(uint32_t), compare);
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (n == 0 || ids[i] != ids[n - 1]) {
+            ids[n++] = ids[i];
+        }
+    }
+    return n;
+}
+
+size_t intersect(const uint32_t *x, size_t xn, const uint32_t *y, size_t yn, uint32_t *result)
+{
+    size_t i = 0, j = 0, n = 0;
+    while (i < xn && j < yn) {
+        if (x[i] < y[j]) {
+            i++;
+        } else if (y[j] < x[i]) {
+            j++;
+        } else {
+            result[n++] = x[i];
+            i++, j++;
+        }
+    }
+    return n;
+}
+
+size_t bitmapBytes(const RND_RoaringBitmap *bitmap)
+{
+    size_t bytes = bitmap->size * sizeof(RND_RoaringBitmapContainer);
+    for (size_t i = 0; i < bitmap->size; i++) {
+        const RND_RoaringBitmapContainer *container = bitmap->containers + i;
+        bytes += (container->type == RND_ROARING_BITMAP_BITSET)? RND_ROARING_BITMAP_WORDS * sizeof(uint64_t) :
+                 (container->type == RND_ROARING_BITMAP_RUN)? container->capacity * 2 * sizeof(uint16_t) :
+                 container->capacity * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+void run(const char *name, uint32_t range)
+{
+    for (size_t i = 0; i < COUNT; i++) {
+        a[i] = randomId(range);
+        b[i] = randomId(range);
+    }
+    size_t an = prepare(a, COUNT), bn = prepare(b, COUNT), n = 0;
+    RND_RoaringBitmap *x = RND_roaringBitmapCreate(), *y = RND_roaringBitmapCreate();
+    for (size_t i = 0; i < an; i++) {
+        RND_roaringBitmapAdd(x, a[i]);
+    }
+    for (size_t i = 0; i < bn; i++) {
+        RND_roaringBitmapAdd(y, b[i]);
+    }
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < REPEATS; i++) {
+        n = intersect(a, an, b, bn, out);
+    }
+    double mid = RND_getWallTime_usec();
+    RND_RoaringBitmap *result = NULL;
+    for (int i = 0; i < REPEATS; i++) {
+        if (result) {
+            RND_roaringBitmapDestroy(result);
+        }
+        result = RND_roaringBitmapCopy(x);
+        RND_roaringBitmapAnd(result, y);
+    }
+    double end = RND_getWallTime_usec();
+    if (RND_roaringBitmapCount(result) != n) {
+        printf("%s: intersection sizes differ\n", name);
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!RND_roaringBitmapContains(result, out[i])) {
+            printf("%s: %u missing from the intersection\n", name, out[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    printf("%-9s | %9lu | %10.2f | %10.2f | %11.2f | %11.2f\n", name, n,
+            (mid - start) / 1000 / REPEATS, (end - mid) / 1000 / REPEATS,
+            (an + bn) * sizeof(uint32_t) / 1e6, (bitmapBytes(x) + bitmapBytes(y)) / 1e6);
+    RND_roaringBitmapDestroy(result);
+    RND_roaringBitmapDestroy(x);
+    RND_roaringBitmapDestroy(y);
+}
+
+int main(int argc, char **argv)
+{
+    srand(1);
+    printf("%d IDs per set\n", COUNT);
+    printf("IDS       |    COMMON | ARRAY (ms) |  ROAR (ms) |  ARRAY (MB) |   ROAR (MB)\n");
+    run("spread", 0);
+    run("packed", 1 << 23);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <RND_RoaringBitmap.h>
+
+int printValue(uint32_t value, void *arg)
+{
+    printf(" %u", value);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    RND_RoaringBitmap *online = RND_roaringBitmapCreate(),
+                      *premium = RND_roaringBitmapCreate();
+
+    // IDs can be spread across the whole 32-bit range
+    RND_roaringBitmapAdd(online, 7);
+    RND_roaringBitmapAdd(online, 70000);
+    RND_roaringBitmapAdd(online, 3000000000u);
+    RND_roaringBitmapAdd(online, 4000000000u);
+    for (uint32_t id = 100; id < 200; id++) {
+        RND_roaringBitmapAdd(premium, id);
+    }
+    RND_roaringBitmapAdd(premium, 7);
+    RND_roaringBitmapAdd(premium, 4000000000u);
+    RND_roaringBitmapOptimize(premium);
+    printf("online: %lu, premium: %lu\n", (unsigned long)RND_roaringBitmapCount(online), (unsigned long)RND_roaringBitmapCount(premium));
+
+    RND_RoaringBitmap *both = RND_roaringBitmapCopy(online);
+    RND_roaringBitmapAnd(both, premium);
+    printf("online and premium:");
+    RND_roaringBitmapMap(both, printValue, NULL);
+    printf("\n");
+
+    RND_roaringBitmapAndNot(online, premium);
+    printf("online, not premium:");
+    RND_roaringBitmapMap(online, printValue, NULL);
+    printf("\n");
+
+    // Dense conversion to and from RND_BitArray
+    RND_roaringBitmapRemove(premium, 4000000000u);
+    RND_BitArray *bits = RND_roaringBitmapToBitArray(premium);
+    printf("bitarray of %lu bits with %lu set\n", RND_bitArraySize(bits), RND_bitArrayCount(bits));
+    RND_bitArrayClearRange(bits, 150, 50);
+    RND_RoaringBitmap *back = RND_roaringBitmapFromBitArray(bits);
+    printf("back from bitarray: %lu values, contains 120: %d, contains 160: %d\n", (unsigned long)RND_roaringBitmapCount(back),
+            RND_roaringBitmapContains(back, 120), RND_roaringBitmapContains(back, 160));
+
+    RND_bitArrayDestroy(bits);
+    RND_roaringBitmapDestroy(back);
+    RND_roaringBitmapDestroy(both);
+    RND_roaringBitmapDestroy(online);
+    RND_roaringBitmapDestroy(premium);
+    return EXIT_SUCCESS;
+}
@@ -191,3 +191,280 @@ int RND_stackCopy(RND_Stack *dest, const RND_Stack *src, void* (*cpy)(const void
     }
     return 0;
 }
+
+RND_StackInline *RND_stackInlineCreate(size_t capacity, size_t elem_size)
+{
+    RND_StackInline *stack;
+    if (!(stack = malloc(sizeof(RND_StackInline)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    if (!capacity || !elem_size) {
+        RND_ERROR("capacity and elem_size must be positive values");
+        free(stack);
+        return NULL;
+    }
+    if (!(stack->data = malloc(elem_size * capacity))) {
+        RND_ERROR("malloc");
+        free(stack);
+        return NULL;
+    }
+    stack->size = 0;
+    stack->capacity = capacity;
+    stack->elem_size = elem_size;
+    return stack;
+}
+
+int RND_stackInlinePush(RND_StackInline *stack, const void *elem)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    if (stack->size == stack->capacity) {
+        char *new;
+        if (!(new = realloc(stack->data, stack->elem_size * stack->capacity * 2))) {
+            RND_ERROR("realloc");
+            return 2;
+        }
+        stack->data = new;
+        stack->capacity *= 2;
+    }
+    memcpy(stack->data + stack->elem_size * stack->size++, elem, stack->elem_size);
+    return 0;
+}
+
+void *RND_stackInlinePeek(const RND_StackInline *stack)
+{
+    return (stack && stack->size > 0)? stack->data + stack->elem_size * (stack->size - 1) : NULL;
+}
+
+int RND_stackInlinePop(RND_StackInline *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    if (stack->size > 0) {
+        stack->size--;
+        int error;
+        void *elem = stack->data + stack->elem_size * stack->size;
+        if (dtor && (error = dtor(elem))) {
+            RND_ERROR("dtor returned %d for element %p", error, elem);
+            return 2;
+        }
+    } else {
+        RND_WARN("the stack is already empty");
+    }
+    return 0;
+}
+
+int RND_stackInlineRemove(RND_StackInline *stack, size_t index, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    if (index >= stack->size) {
+        RND_ERROR("index out of range");
+        return 3;
+    }
+    char *target = stack->data + stack->elem_size * (stack->size - 1 - index);
+    int error;
+    if (dtor && (error = dtor(target))) {
+        RND_ERROR("dtor returned %d for element %p", error, (void*)target);
+        return 2;
+    }
+    memmove(target, target + stack->elem_size, stack->elem_size * index);
+    stack->size--;
+    return 0;
+}
+
+int RND_stackInlineClear(RND_StackInline *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    if (dtor) {
+        while (stack->size) {
+            stack->size--;
+            int error;
+            void *elem = stack->data + stack->elem_size * stack->size;
+            if ((error = dtor(elem))) {
+                RND_ERROR("dtor returned %d for element %p", error, elem);
+                return 2;
+            }
+        }
+    } else {
+        stack->size = 0;
+    }
+    return 0;
+}
+
+int RND_stackInlineDestroy(RND_StackInline *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_stackInlineClear(stack, dtor))) {
+        RND_ERROR("RND_stackInlineClear returned error %d", error);
+        return error;
+    }
+    free(stack->data);
+    free(stack);
+    return 0;
+}
+
+size_t RND_stackInlineSize(const RND_StackInline *stack)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 0;
+    }
+    return stack->size;
+}
+
+RND_StackSeg *RND_stackSegCreate(size_t chunk_capacity)
+{
+    RND_StackSeg *stack;
+    if (!(stack = malloc(sizeof(RND_StackSeg)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    if (!chunk_capacity) {
+        RND_ERROR("chunk_capacity must be a positive value");
+        free(stack);
+        return NULL;
+    }
+    if (!(stack->top = malloc(sizeof(RND_StackSegChunk) + sizeof(void*) * chunk_capacity))) {
+        RND_ERROR("malloc");
+        free(stack);
+        return NULL;
+    }
+    stack->top->prev = NULL;
+    stack->spare = NULL;
+    stack->top_size = 0;
+    stack->chunk_capacity = chunk_capacity;
+    stack->size = 0;
+    return stack;
+}
+
+int RND_stackSegPush(RND_StackSeg *stack, const void *data)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    if (stack->top_size == stack->chunk_capacity) {
+        RND_StackSegChunk *new;
+        if (stack->spare) {
+            new = stack->spare;
+            stack->spare = NULL;
+        } else if (!(new = malloc(sizeof(RND_StackSegChunk) + sizeof(void*) * stack->chunk_capacity))) {
+            RND_ERROR("malloc");
+            return 2;
+        }
+        new->prev = stack->top;
+        stack->top = new;
+        stack->top_size = 0;
+    }
+    stack->top->data[stack->top_size++] = (void*)data;
+    stack->size++;
+    return 0;
+}
+
+void *RND_stackSegPeek(const RND_StackSeg *stack)
+{
+    return (stack && stack->size > 0)? stack->top->data[stack->top_size - 1] : NULL;
+}
+
+void **RND_stackSegAt(const RND_StackSeg *stack, size_t index)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return NULL;
+    }
+    if (index >= stack->size) {
+        RND_ERROR("index out of range");
+        return NULL;
+    }
+    RND_StackSegChunk *chunk = stack->top;
+    size_t count = stack->top_size;
+    while (index >= count) {
+        index -= count;
+        chunk = chunk->prev;
+        count = stack->chunk_capacity;
+    }
+    return chunk->data + count - 1 - index;
+}
+
+int RND_stackSegPop(RND_StackSeg *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    if (stack->size > 0) {
+        int error;
+        void *data = stack->top->data[stack->top_size - 1];
+        if (dtor && (error = dtor(data))) {
+            RND_ERROR("dtor returned %d for data %p", error, data);
+            return 2;
+        }
+        stack->size--;
+        if (--stack->top_size == 0 && stack->top->prev) {
+            // Keep the emptied chunk as the spare, dropping the older one
+            free(stack->spare);
+            stack->spare = stack->top;
+            stack->top = stack->top->prev;
+            stack->top_size = stack->chunk_capacity;
+        }
+    } else {
+        RND_WARN("the stack is already empty");
+    }
+    return 0;
+}
+
+int RND_stackSegClear(RND_StackSeg *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    while (stack->size) {
+        int error;
+        if ((error = RND_stackSegPop(stack, dtor))) {
+            return error;
+        }
+    }
+    return 0;
+}
+
+int RND_stackSegDestroy(RND_StackSeg *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_stackSegClear(stack, dtor))) {
+        RND_ERROR("RND_stackSegClear returned error %d", error);
+        return error;
+    }
+    free(stack->top);
+    free(stack->spare);
+    free(stack);
+    return 0;
+}
+
+size_t RND_stackSegSize(const RND_StackSeg *stack)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 0;
+    }
+    return stack->size;
+}
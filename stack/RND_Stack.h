@@ -16,6 +16,9 @@
 
 /// @cond
 typedef struct RND_Stack RND_Stack;
+typedef struct RND_StackInline RND_StackInline;
+typedef struct RND_StackSeg RND_StackSeg;
+typedef struct RND_StackSegChunk RND_StackSegChunk;
 /// @endcond
 
 /** A LIFO stack structure for arbitrary data.
@@ -34,6 +37,68 @@ struct RND_Stack
     size_t capacity;
 };
 
+/** A LIFO stack structure storing elements by value.
+ *
+ * Unlike @ref RND_Stack, which only stores pointers, this
+ * stack copies whole elements of a fixed size (set at the
+ * time of creation) directly into its array. Small records
+ * can therefore be pushed without allocating them first,
+ * and reading them back costs no extra indirection.
+ */
+struct RND_StackInline
+{
+    /// A contiguous array of the stored elements.
+    char *data;
+    /// The number of elements on the stack.
+    size_t size;
+    /// The number of elements the @ref RND_StackInline::data
+    /// array can hold (this number will change dynamically).
+    size_t capacity;
+    /// The size of a single element (in bytes).
+    size_t elem_size;
+};
+
+/** A single fixed-size chunk of a @ref RND_StackSeg.
+ *
+ * Chunks are allocated in one block together with their
+ * array of pointers, and they never move or get resized.
+ */
+struct RND_StackSegChunk
+{
+    /// The chunk right below this one (@c NULL for the bottom one).
+    RND_StackSegChunk *prev;
+    /// An array of @ref RND_StackSeg::chunk_capacity pointers to the stored data.
+    void *data[];
+};
+
+/** A segmented LIFO stack structure for arbitrary data.
+ *
+ * @ref RND_Stack grows by doubling its array with @c realloc,
+ * which copies the whole stack and invalidates any pointers
+ * into @ref RND_Stack::data. This stack instead grows by
+ * linking fixed-size chunks together, so every push is O(1)
+ * in the worst case and an element's slot (see @ref
+ * RND_stackSegAt) stays at the same address for as long as
+ * the element is on the stack.
+ *
+ * The most recently emptied chunk is kept around as a spare,
+ * so pushing and popping back and forth across a chunk
+ * boundary doesn't call @c malloc and @c free every time.
+ */
+struct RND_StackSeg
+{
+    /// The chunk holding the top element.
+    RND_StackSegChunk *top;
+    /// An empty chunk kept for reuse (may be @c NULL).
+    RND_StackSegChunk *spare;
+    /// The number of elements in the @ref RND_StackSeg::top chunk.
+    size_t top_size;
+    /// The number of elements that fit in a single chunk.
+    size_t chunk_capacity;
+    /// The number of elements on the stack.
+    size_t size;
+};
+
 
 /********************************************************
  *                     FUNCTIONS                        *
@@ -194,4 +259,195 @@ int RND_stackPrint(const RND_Stack *stack);
  */
 int RND_stackCopy(RND_Stack *dest, const RND_Stack *src, void* (*cpy)(const void *));
 
+/** Allocates a new empty by-value stack and returns its pointer.
+ *
+ * @param[in] capacity The number of elements to preallocate
+ * for (cannot be 0). This number will be automatically doubled each
+ * time more space is needed due to pushing elements.
+ * @param[in] elem_size The size of a single element in bytes
+ * (cannot be 0), usually @c sizeof of the stored type.
+ * @returns
+ * - the new stack's address - success
+ * - @c NULL - insufficient memory or invalid @p capacity
+ *   or @p elem_size value
+ */
+RND_StackInline *RND_stackInlineCreate(size_t capacity, size_t elem_size);
+
+/** Copies an element onto the top of a by-value stack.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] elem A pointer to the element to be copied
+ * (@ref RND_StackInline::elem_size bytes are read).
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - realloc failed (insufficient memory)
+ */
+int RND_stackInlinePush(RND_StackInline *stack, const void *elem);
+
+/** Returns a pointer to the top element of a by-value stack.
+ *
+ * The returned pointer points inside @ref RND_StackInline::data,
+ * so it is only valid until the next push or removal.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the address of the top element - success
+ * - @c NULL - @p stack is @c NULL or empty
+ */
+void *RND_stackInlinePeek(const RND_StackInline *stack);
+
+/** Removes the top element from a by-value stack.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor A pointer to a function which intakes
+ * the address of an element and frees whatever it owns
+ * (but not the element itself), returning 0 for success
+ * and anything else for failure @b OR @c NULL if the
+ * elements don't need any cleanup.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_stackInlinePop(RND_StackInline *stack, int (*dtor)(const void*));
+
+/** Removes an element from a by-value stack by index.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] index The index of the element to remove (starting at head = 0).
+ * @param[in] dtor Same as in @ref RND_stackInlinePop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ * - 3 - @p index out of range
+ */
+int RND_stackInlineRemove(RND_StackInline *stack, size_t index, int (*dtor)(const void*));
+
+/** Removes all elements from a by-value stack.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor Same as in @ref RND_stackInlinePop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_stackInlineClear(RND_StackInline *stack, int (*dtor)(const void*));
+
+/** Frees all memory associated with a by-value stack.
+ *
+ * First frees the contents of the stack with @ref
+ * RND_stackInlineClear, then frees the @ref RND_StackInline
+ * struct itself.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param [in] dtor This argument is passed directly
+ * to @ref RND_stackInlineClear.
+ */
+int RND_stackInlineDestroy(RND_StackInline *stack, int (*dtor)(const void*));
+
+/** Returns the number of elements in a by-value stack.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the size of the stack (@ref RND_StackInline::size) - success
+ * - 0 - if @p stack is @c NULL (or stack is empty)
+ */
+size_t RND_stackInlineSize(const RND_StackInline *stack);
+
+/** Allocates a new empty segmented stack and returns its pointer.
+ *
+ * @param[in] chunk_capacity The number of elements in a single
+ * chunk (cannot be 0). The first chunk is allocated right away.
+ * @returns
+ * - the new stack's address - success
+ * - @c NULL - insufficient memory or invalid @p chunk_capacity
+ *   value
+ */
+RND_StackSeg *RND_stackSegCreate(size_t chunk_capacity);
+
+/** Adds an element in front of a segmented stack.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] data A pointer to the data to be stored.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - malloc failed (insufficient memory)
+ */
+int RND_stackSegPush(RND_StackSeg *stack, const void *data);
+
+/** Returns a pointer to the top element of a segmented stack.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the top element's data - success
+ * - @c NULL - @p stack is @c NULL or empty
+ */
+void *RND_stackSegPeek(const RND_StackSeg *stack);
+
+/** Returns the address of an element's slot in a segmented stack.
+ *
+ * Unlike with @ref RND_Stack, the returned address remains
+ * valid until the element is popped, no matter how many
+ * elements get pushed in the meantime.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @param[in] index The index of the element (starting at head = 0).
+ * @returns
+ * - the address of the slot holding the element - success
+ * - @c NULL - @p stack is @c NULL or @p index out of range
+ */
+void **RND_stackSegAt(const RND_StackSeg *stack, size_t index);
+
+/** Removes the top element from a segmented stack.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor A pointer to a function which intakes
+ * a stored data pointer and frees it, returning 0 for
+ * success and anything else for failure @b OR @c NULL
+ * if the data elements don't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_stackSegPop(RND_StackSeg *stack, int (*dtor)(const void*));
+
+/** Removes all elements from a segmented stack.
+ *
+ * All chunks except for the bottom one are freed.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor Same as in @ref RND_stackSegPop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_stackSegClear(RND_StackSeg *stack, int (*dtor)(const void*));
+
+/** Frees all memory associated with a segmented stack.
+ *
+ * First frees the contents of the stack with @ref
+ * RND_stackSegClear, then frees the remaining chunks
+ * and the @ref RND_StackSeg struct itself.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param [in] dtor This argument is passed directly
+ * to @ref RND_stackSegClear.
+ */
+int RND_stackSegDestroy(RND_StackSeg *stack, int (*dtor)(const void*));
+
+/** Returns the number of elements in a segmented stack.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the size of the stack (@ref RND_StackSeg::size) - success
+ * - 0 - if @p stack is @c NULL (or stack is empty)
+ */
+size_t RND_stackSegSize(const RND_StackSeg *stack);
+
 #endif /* RND_STACK_H */
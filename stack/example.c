@@ -12,6 +12,11 @@ int push(RND_Stack *stack, int val)
     return RND_stackPush(stack, new);
 }
 
+typedef struct Point
+{
+    int x, y;
+} Point;
+
 int main(int argc, char **argv)
 {
     RND_Stack *test = RND_stackCreate(10);
@@ -44,5 +49,33 @@ int main(int argc, char **argv)
     RND_stackDestroy(test, RND_stackDtorFree);
     RND_stackDestroy(copy, NULL);
 
+    // Small records can be stored by value, without mallocing each of them
+    RND_StackInline *points = RND_stackInlineCreate(4, sizeof(Point));
+    for (int i = 0; i < 10; i++) {
+        Point p = { i, i * i };
+        RND_stackInlinePush(points, &p);
+    }
+    RND_stackInlineRemove(points, 2, NULL);
+    Point *top = (Point*)RND_stackInlinePeek(points);
+    printf("top point: (%d, %d), size: %lu\n", top->x, top->y, RND_stackInlineSize(points));
+    RND_stackInlineDestroy(points, NULL);
+
+    // Segmented stacks grow chunk by chunk, so element slots never move
+    RND_StackSeg *seg = RND_stackSegCreate(4);
+    int values[10];
+    for (int i = 0; i < 10; i++) {
+        values[i] = i * 100;
+        RND_stackSegPush(seg, values + i);
+    }
+    void **bottom = RND_stackSegAt(seg, RND_stackSegSize(seg) - 1);
+    for (int i = 0; i < 100; i++) {
+        RND_stackSegPush(seg, values);
+    }
+    for (int i = 0; i < 103; i++) {
+        RND_stackSegPop(seg, NULL);
+    }
+    printf("bottom slot %p still holds %d, top: %d\n", (void*)bottom, *(int*)*bottom, *(int*)RND_stackSegPeek(seg));
+    RND_stackSegDestroy(seg, NULL);
+
     return EXIT_SUCCESS;
 }
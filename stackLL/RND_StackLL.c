@@ -1,5 +1,6 @@
 #include <malloc.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include <RND_ErrMsg.h>
 #include "RND_StackLL.h"
 
@@ -146,3 +147,236 @@ int RND_stackLLPrint(const RND_StackLL **stack)
     printf("+-----------------------------------------+\n");
     return ret;
 }
+
+int RND_stackLLIntrusiveInit(RND_StackLLIntrusive *stack)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    stack->top = NULL;
+    stack->size = 0;
+    return 0;
+}
+
+int RND_stackLLIntrusivePush(RND_StackLLIntrusive *stack, RND_StackLLLink *link)
+{
+    if (!stack || !link) {
+        RND_ERROR("the stack or link does not exist");
+        return 1;
+    }
+    link->prev = NULL;
+    link->next = stack->top;
+    if (stack->top) {
+        stack->top->prev = link;
+    }
+    stack->top = link;
+    stack->size++;
+    return 0;
+}
+
+RND_StackLLLink *RND_stackLLIntrusivePeek(const RND_StackLLIntrusive *stack)
+{
+    return stack? stack->top : NULL;
+}
+
+RND_StackLLLink *RND_stackLLIntrusivePop(RND_StackLLIntrusive *stack)
+{
+    if (!stack || !stack->top) {
+        RND_WARN("the stack is already empty");
+        return NULL;
+    }
+    RND_StackLLLink *ret = stack->top;
+    RND_stackLLIntrusiveRemove(stack, ret);
+    return ret;
+}
+
+int RND_stackLLIntrusiveRemove(RND_StackLLIntrusive *stack, RND_StackLLLink *link)
+{
+    if (!stack || !link) {
+        RND_ERROR("the stack or link does not exist");
+        return 1;
+    }
+    if (link->prev) {
+        link->prev->next = link->next;
+    } else {
+        stack->top = link->next;
+    }
+    if (link->next) {
+        link->next->prev = link->prev;
+    }
+    link->prev = link->next = NULL;
+    stack->size--;
+    return 0;
+}
+
+size_t RND_stackLLIntrusiveSize(const RND_StackLLIntrusive *stack)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 0;
+    }
+    return stack->size;
+}
+
+// Lock-free push of a node onto a tagged list top
+static void RND_stackLLAtomicPushNode(RND_StackLLAtomicTop *top, RND_StackLLAtomicNode *node)
+{
+    RND_StackLLAtomicTop old, new;
+    __atomic_load(top, &old, __ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(&node->next, old.node, __ATOMIC_RELAXED);
+        new.node = node;
+        new.tag  = old.tag + 1;
+    } while (!__atomic_compare_exchange(top, &old, &new, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Lock-free pop of a node from a tagged list top (NULL if empty)
+static RND_StackLLAtomicNode *RND_stackLLAtomicPopNode(RND_StackLLAtomicTop *top)
+{
+    RND_StackLLAtomicTop old, new;
+    __atomic_load(top, &old, __ATOMIC_ACQUIRE);
+    do {
+        if (!old.node) {
+            return NULL;
+        }
+        /* The node may have been popped by another thread already,
+         * but nodes are never freed while the stack exists, so the
+         * read is safe and the tag makes the swap below fail.
+         */
+        new.node = __atomic_load_n(&old.node->next, __ATOMIC_RELAXED);
+        new.tag  = old.tag + 1;
+    } while (!__atomic_compare_exchange(top, &old, &new, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+    return old.node;
+}
+
+RND_StackLLAtomic *RND_stackLLAtomicCreate()
+{
+    RND_StackLLAtomic *stack;
+    if (!(stack = (RND_StackLLAtomic*)malloc(sizeof(RND_StackLLAtomic)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    stack->top.node  = NULL;
+    stack->top.tag   = 0;
+    stack->free.node = NULL;
+    stack->free.tag  = 0;
+    stack->size      = 0;
+    return stack;
+}
+
+int RND_stackLLAtomicPush(RND_StackLLAtomic *stack, const void *data)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 2;
+    }
+    RND_StackLLAtomicNode *node;
+    if (!(node = RND_stackLLAtomicPopNode(&stack->free))
+            && !(node = (RND_StackLLAtomicNode*)malloc(sizeof(RND_StackLLAtomicNode)))) {
+        RND_ERROR("malloc");
+        return 1;
+    }
+    __atomic_store_n(&node->data, (void*)data, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stack->size, 1, __ATOMIC_RELAXED);
+    RND_stackLLAtomicPushNode(&stack->top, node);
+    return 0;
+}
+
+void *RND_stackLLAtomicPeek(RND_StackLLAtomic *stack)
+{
+    if (!stack) {
+        return NULL;
+    }
+    RND_StackLLAtomicTop top;
+    __atomic_load(&stack->top, &top, __ATOMIC_ACQUIRE);
+    return top.node? __atomic_load_n(&top.node->data, __ATOMIC_RELAXED) : NULL;
+}
+
+void *RND_stackLLAtomicTake(RND_StackLLAtomic *stack)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return NULL;
+    }
+    RND_StackLLAtomicNode *node;
+    if (!(node = RND_stackLLAtomicPopNode(&stack->top))) {
+        return NULL;
+    }
+    __atomic_sub_fetch(&stack->size, 1, __ATOMIC_RELAXED);
+    void *data = __atomic_load_n(&node->data, __ATOMIC_RELAXED);
+    RND_stackLLAtomicPushNode(&stack->free, node);
+    return data;
+}
+
+int RND_stackLLAtomicPop(RND_StackLLAtomic *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    RND_StackLLAtomicNode *node;
+    if (!(node = RND_stackLLAtomicPopNode(&stack->top))) {
+        RND_WARN("the stack is already empty");
+        return 1;
+    }
+    __atomic_sub_fetch(&stack->size, 1, __ATOMIC_RELAXED);
+    void *data = __atomic_load_n(&node->data, __ATOMIC_RELAXED);
+    RND_stackLLAtomicPushNode(&stack->free, node);
+    int error;
+    if (dtor && (error = dtor(data))) {
+        RND_ERROR("dtor returned %d for data %p", error, data);
+        return 2;
+    }
+    return 0;
+}
+
+int RND_stackLLAtomicClear(RND_StackLLAtomic *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    RND_StackLLAtomicNode *node;
+    while ((node = RND_stackLLAtomicPopNode(&stack->top))) {
+        __atomic_sub_fetch(&stack->size, 1, __ATOMIC_RELAXED);
+        void *data = __atomic_load_n(&node->data, __ATOMIC_RELAXED);
+        RND_stackLLAtomicPushNode(&stack->free, node);
+        int error;
+        if (dtor && (error = dtor(data))) {
+            RND_ERROR("dtor returned %d for data %p", error, data);
+            return 2;
+        }
+    }
+    return 0;
+}
+
+int RND_stackLLAtomicDestroy(RND_StackLLAtomic *stack, int (*dtor)(const void*))
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 1;
+    }
+    int error;
+    if ((error = RND_stackLLAtomicClear(stack, dtor))) {
+        RND_ERROR("RND_stackLLAtomicClear returned error %d", error);
+        return error;
+    }
+    RND_StackLLAtomicNode *i = stack->free.node;
+    while (i) {
+        RND_StackLLAtomicNode *j = i->next;
+        free(i);
+        i = j;
+    }
+    free(stack);
+    return 0;
+}
+
+size_t RND_stackLLAtomicSize(RND_StackLLAtomic *stack)
+{
+    if (!stack) {
+        RND_ERROR("the stack does not exist");
+        return 0;
+    }
+    return __atomic_load_n(&stack->size, __ATOMIC_RELAXED);
+}
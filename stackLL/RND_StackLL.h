@@ -14,6 +14,22 @@
 #define RND_STACK_LL_H
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/********************************************************
+ *                      MACROS                          *
+ ********************************************************/
+
+/** Returns the address of the struct an intrusive link is embedded in.
+ *
+ * @param[in] link A pointer to a @ref RND_StackLLLink.
+ * @param[in] type The type of the struct which contains the link.
+ * @param[in] member The name of the link field inside @p type.
+ */
+#define RND_STACKLL_ENTRY(link, type, member) \
+    ((type*)((char*)(link) - offsetof(type, member)))
+
 
 /********************************************************
  *                    STRUCTURES                        *
@@ -21,6 +37,11 @@
 
 /// @cond
 typedef struct RND_StackLL RND_StackLL;
+typedef struct RND_StackLLLink RND_StackLLLink;
+typedef struct RND_StackLLIntrusive RND_StackLLIntrusive;
+typedef struct RND_StackLLAtomic RND_StackLLAtomic;
+typedef struct RND_StackLLAtomicNode RND_StackLLAtomicNode;
+typedef struct RND_StackLLAtomicTop RND_StackLLAtomicTop;
 /// @endcond
 
 /** A LIFO stack structure for arbitrary data.
@@ -38,6 +59,93 @@ struct RND_StackLL
     RND_StackLL *next;
 };
 
+/** A link field to be embedded in user structs.
+ *
+ * To make a struct storable in a @ref RND_StackLLIntrusive,
+ * give it a member of this type and pass that member's address
+ * to the stack functions. Use @ref RND_STACKLL_ENTRY to get
+ * back from a link to the struct containing it.
+ *
+ * A link can only belong to one stack at a time.
+ */
+struct RND_StackLLLink
+{
+    /// The link above this one (@c NULL for the top one).
+    RND_StackLLLink *prev;
+    /// The link below this one (@c NULL for the bottom one).
+    RND_StackLLLink *next;
+};
+
+/** An intrusive LIFO stack.
+ *
+ * Instead of allocating a @ref RND_StackLL for every element,
+ * the stack is threaded through links embedded in the elements
+ * themselves, so pushing an existing object costs zero
+ * allocations and any element can be unlinked in constant time
+ * given its address. The stack never frees anything - it is up
+ * to the user to keep the elements alive while they're linked.
+ */
+struct RND_StackLLIntrusive
+{
+    /// The top link of the stack (@c NULL if empty).
+    RND_StackLLLink *top;
+    /// The number of links on the stack.
+    size_t size;
+};
+
+/// A single element of a @ref RND_StackLLAtomic.
+struct RND_StackLLAtomicNode
+{
+    /// A pointer to the stored data.
+    void *data;
+    /// A pointer to the next stack element.
+    RND_StackLLAtomicNode *next;
+};
+
+/** A tagged pointer to the top of a lock-free stack.
+ *
+ * The tag is incremented on every successful update, so a
+ * compare-and-swap fails whenever the top has been popped
+ * and pushed back in the meantime (the ABA problem), even
+ * if it ended up being the very same node. The struct is
+ * swapped as a whole with a double-width compare-and-swap.
+ */
+struct RND_StackLLAtomicTop
+{
+    /// The top node (@c NULL if empty).
+    RND_StackLLAtomicNode *node;
+    /// The modification counter.
+    uintptr_t tag;
+} __attribute__((aligned(2 * sizeof(void*))));
+
+/** A lock-free LIFO stack which can be shared between threads.
+ *
+ * This is a Treiber stack - pushing and popping are done with
+ * a single compare-and-swap on the tagged @ref
+ * RND_StackLLAtomic::top pointer, retried until no other thread
+ * got in the way. Popped nodes are not freed, but moved onto the
+ * internal @ref RND_StackLLAtomic::free list and reused by later
+ * pushes, so a thread that lost a race never reads freed memory.
+ * All nodes are freed at once by @ref RND_stackLLAtomicDestroy.
+ *
+ * Compile and link with @c -latomic (the double-width
+ * compare-and-swap is provided by libatomic).
+ */
+struct RND_StackLLAtomic
+{
+    /// The top of the stack.
+    RND_StackLLAtomicTop top;
+    /// The top of the list of unused nodes.
+    RND_StackLLAtomicTop free;
+    /** The number of elements on the stack.
+     *
+     * While other threads are pushing or popping,
+     * this may be briefly greater than the real number
+     * of elements, but it is never smaller.
+     */
+    size_t size;
+};
+
 
 /********************************************************
  *                     FUNCTIONS                        *
@@ -207,4 +315,165 @@ int RND_stackLLPrintMap(const RND_StackLL *elem, size_t index);
  */
 int RND_stackLLDtorFree(const void *data);
 
+/** Initializes an empty intrusive stack.
+ *
+ * Intrusive stacks do not own any memory, so there is no
+ * matching destroy function - the struct may live on the
+ * stack or inside some other struct.
+ *
+ * @param[out] stack A pointer to the stack to initialize.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ */
+int RND_stackLLIntrusiveInit(RND_StackLLIntrusive *stack);
+
+/** Puts a link on top of an intrusive stack.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[inout] link A pointer to a link which isn't part of any stack.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack or @p link is @c NULL
+ */
+int RND_stackLLIntrusivePush(RND_StackLLIntrusive *stack, RND_StackLLLink *link);
+
+/** Returns the top link of an intrusive stack.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the top link - success
+ * - @c NULL - the stack is empty or @p stack is @c NULL
+ */
+RND_StackLLLink *RND_stackLLIntrusivePeek(const RND_StackLLIntrusive *stack);
+
+/** Unlinks the top link of an intrusive stack and returns it.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @returns
+ * - the removed link - success
+ * - @c NULL - the stack is empty or @p stack is @c NULL
+ */
+RND_StackLLLink *RND_stackLLIntrusivePop(RND_StackLLIntrusive *stack);
+
+/** Unlinks any link from an intrusive stack in constant time.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[inout] link A pointer to a link which is part of @p stack.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack or @p link is @c NULL
+ */
+int RND_stackLLIntrusiveRemove(RND_StackLLIntrusive *stack, RND_StackLLLink *link);
+
+/** Returns the number of links on an intrusive stack.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the size of the stack (@ref RND_StackLLIntrusive::size) - success
+ * - 0 - if @p stack is @c NULL (or stack is empty)
+ */
+size_t RND_stackLLIntrusiveSize(const RND_StackLLIntrusive *stack);
+
+/** Allocates a new empty lock-free stack and returns its pointer.
+ *
+ * @returns
+ * - the new stack's address - success
+ * - @c NULL - insufficient memory
+ */
+RND_StackLLAtomic *RND_stackLLAtomicCreate();
+
+/** Adds an element in front of a lock-free stack.
+ *
+ * This function is thread-safe. It only allocates memory
+ * if there are no unused nodes left over from earlier pops.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] data The address of the data to be stored.
+ * @returns
+ * - 0 - success
+ * - 1 - insufficient memory
+ * - 2 - @p stack is @c NULL
+ */
+int RND_stackLLAtomicPush(RND_StackLLAtomic *stack, const void *data);
+
+/** Returns a pointer to the top element of a lock-free stack.
+ *
+ * This function is thread-safe, but by the time it returns,
+ * other threads may have already popped the element.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the top element's data - success
+ * - @c NULL - the stack is empty or @p stack is @c NULL
+ */
+void *RND_stackLLAtomicPeek(RND_StackLLAtomic *stack);
+
+/** Removes the top element of a lock-free stack.
+ *
+ * This function is thread-safe. Unlike with @ref RND_stackLLPop,
+ * the element is already removed by the time @p dtor is called,
+ * so it does not get restored if @p dtor fails.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor A pointer to a function which intakes
+ * the stored data and frees it, returning 0 for success
+ * and anything else for failure @b OR @c NULL if the data
+ * doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - the stack is empty or @p stack is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_stackLLAtomicPop(RND_StackLLAtomic *stack, int (*dtor)(const void*));
+
+/** Removes the top element of a lock-free stack and returns its data.
+ *
+ * Calling @ref RND_stackLLAtomicPeek and then @ref
+ * RND_stackLLAtomicPop is not atomic, because another thread
+ * may pop the element in between. This function does both
+ * in one step, which is what a shared free list needs.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @returns
+ * - the removed element's data - success
+ * - @c NULL - the stack is empty or @p stack is @c NULL
+ */
+void *RND_stackLLAtomicTake(RND_StackLLAtomic *stack);
+
+/** Removes all elements from a lock-free stack.
+ *
+ * This function is thread-safe, but elements pushed by other
+ * threads while it runs may or may not be removed.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor Same as in @ref RND_stackLLAtomicPop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p stack is @c NULL
+ * - 2 - some @p dtor returned non-0 (clearing was interrupted)
+ */
+int RND_stackLLAtomicClear(RND_StackLLAtomic *stack, int (*dtor)(const void*));
+
+/** Frees all memory associated with a lock-free stack.
+ *
+ * First removes all elements with @ref RND_stackLLAtomicClear,
+ * then frees all nodes and the @ref RND_StackLLAtomic struct
+ * itself. No other thread may be using the stack at this point.
+ *
+ * @param[inout] stack A pointer to the stack.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_stackLLAtomicClear.
+ */
+int RND_stackLLAtomicDestroy(RND_StackLLAtomic *stack, int (*dtor)(const void*));
+
+/** Returns the number of elements on a lock-free stack.
+ *
+ * @param[in] stack A pointer to the stack.
+ * @returns
+ * - the size of the stack (@ref RND_StackLLAtomic::size) - success
+ * - 0 - if @p stack is @c NULL (or stack is empty)
+ */
+size_t RND_stackLLAtomicSize(RND_StackLLAtomic *stack);
+
 #endif /* RND_STACK_LL_H */
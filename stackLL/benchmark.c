@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <RND_StackLL.h>
+#include <RND_Utils.h>
+
+#define MAX_THREADS 8
+#define ITEMS_PER_THREAD 200000
+
+/* Every thread pushes its own items onto a shared stack and takes
+ * items back in between, like threads sharing a free list would.
+ * Afterwards each item must have been taken exactly once.
+ */
+
+typedef struct Worker
+{
+    pthread_t thread;
+    int *items;
+} Worker;
+
+RND_StackLLAtomic *atomic_stack;
+RND_StackLL *locked_stack;
+pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+unsigned char *seen;
+
+void mark(int *item)
+{
+    __atomic_add_fetch(seen + *item, 1, __ATOMIC_RELAXED);
+}
+
+void *runAtomic(void *arg)
+{
+    Worker *w = (Worker*)arg;
+    for (int i = 0; i < ITEMS_PER_THREAD; i++) {
+        RND_stackLLAtomicPush(atomic_stack, w->items + i);
+        if (i % 2) {
+            int *item;
+            if ((item = (int*)RND_stackLLAtomicTake(atomic_stack))) {
+                mark(item);
+            }
+        }
+    }
+    return NULL;
+}
+
+void *runLocked(void *arg)
+{
+    Worker *w = (Worker*)arg;
+    for (int i = 0; i < ITEMS_PER_THREAD; i++) {
+        pthread_mutex_lock(&lock);
+        RND_stackLLPush(&locked_stack, w->items + i);
+        pthread_mutex_unlock(&lock);
+        if (i % 2) {
+            int *item;
+            pthread_mutex_lock(&lock);
+            if ((item = (int*)RND_stackLLPeek((const RND_StackLL**)&locked_stack))) {
+                RND_stackLLPop(&locked_stack, NULL);
+            }
+            pthread_mutex_unlock(&lock);
+            if (item) {
+                mark(item);
+            }
+        }
+    }
+    return NULL;
+}
+
+bool verify(int nthreads)
+{
+    for (int i = 0; i < nthreads * ITEMS_PER_THREAD; i++) {
+        if (seen[i] != 1) {
+            printf("item %d was taken %d times\n", i, seen[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int *items = malloc(sizeof(int) * MAX_THREADS * ITEMS_PER_THREAD);
+    seen = malloc(MAX_THREADS * ITEMS_PER_THREAD);
+    if (!items || !seen) {
+        fprintf(stderr, "malloc error\n");
+        exit(1);
+    }
+    for (int i = 0; i < MAX_THREADS * ITEMS_PER_THREAD; i++) {
+        items[i] = i;
+    }
+    printf("threads | lock-free (ms) | mutex (ms)\n");
+    for (int n = 1; n <= MAX_THREADS; n *= 2) {
+        Worker workers[MAX_THREADS];
+        double time[2];
+        for (int pass = 0; pass < 2; pass++) {
+            for (int i = 0; i < n * ITEMS_PER_THREAD; i++) {
+                seen[i] = 0;
+            }
+            atomic_stack = RND_stackLLAtomicCreate();
+            locked_stack = RND_stackLLCreate();
+            double start = RND_getWallTime_usec();
+            for (int t = 0; t < n; t++) {
+                workers[t].items = items + t * ITEMS_PER_THREAD;
+                pthread_create(&workers[t].thread, NULL, pass? runLocked : runAtomic, workers + t);
+            }
+            for (int t = 0; t < n; t++) {
+                pthread_join(workers[t].thread, NULL);
+            }
+            time[pass] = (RND_getWallTime_usec() - start) / 1000;
+            int *item;
+            if (pass) {
+                while ((item = (int*)RND_stackLLPeek((const RND_StackLL**)&locked_stack))) {
+                    mark(item);
+                    RND_stackLLPop(&locked_stack, NULL);
+                }
+            } else {
+                while ((item = (int*)RND_stackLLAtomicTake(atomic_stack))) {
+                    mark(item);
+                }
+            }
+            if (!verify(n)) {
+                return EXIT_FAILURE;
+            }
+            RND_stackLLAtomicDestroy(atomic_stack, NULL);
+            RND_stackLLDestroy(&locked_stack, NULL);
+        }
+        printf("%7d | %14.2f | %10.2f\n", n, time[0], time[1]);
+    }
+    free(items);
+    free(seen);
+    return EXIT_SUCCESS;
+}
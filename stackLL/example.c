@@ -12,6 +12,12 @@ int push(RND_StackLL **stack, int val)
     return RND_stackLLPush(stack, new);
 }
 
+typedef struct Task
+{
+    int id;
+    RND_StackLLLink link;
+} Task;
+
 int main(int argc, char **argv)
 {
     RND_StackLL *test = RND_stackLLCreate();
@@ -39,5 +45,30 @@ int main(int argc, char **argv)
     RND_stackLLPrint(&test);
     RND_stackLLDestroy(&test, RND_stackLLDtorFree);
 
+    // Intrusive stacks thread through a link embedded in the elements
+    Task tasks[5];
+    RND_StackLLIntrusive free_tasks;
+    RND_stackLLIntrusiveInit(&free_tasks);
+    for (int i = 0; i < 5; i++) {
+        tasks[i].id = i;
+        RND_stackLLIntrusivePush(&free_tasks, &tasks[i].link);
+    }
+    RND_stackLLIntrusiveRemove(&free_tasks, &tasks[2].link);
+    RND_StackLLLink *top = RND_stackLLIntrusivePop(&free_tasks);
+    printf("popped task %d, %lu left, next on top: %d\n", RND_STACKLL_ENTRY(top, Task, link)->id,
+            RND_stackLLIntrusiveSize(&free_tasks),
+            RND_STACKLL_ENTRY(RND_stackLLIntrusivePeek(&free_tasks), Task, link)->id);
+
+    // Lock-free stacks can be shared between threads without any locking
+    RND_StackLLAtomic *shared = RND_stackLLAtomicCreate();
+    for (int i = 0; i < 5; i++) {
+        RND_stackLLAtomicPush(shared, &tasks[i]);
+    }
+    Task *taken = (Task*)RND_stackLLAtomicTake(shared);
+    RND_stackLLAtomicPop(shared, NULL);
+    printf("took task %d, %lu left, top: %d\n", taken->id, RND_stackLLAtomicSize(shared),
+            ((Task*)RND_stackLLAtomicPeek(shared))->id);
+    RND_stackLLAtomicDestroy(shared, NULL);
+
     return EXIT_SUCCESS;
 }
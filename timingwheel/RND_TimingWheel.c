@@ -0,0 +1,268 @@
+#include <malloc.h>
+#include <stdio.h>
+#include <RND_ErrMsg.h>
+#include "RND_TimingWheel.h"
+
+// Map a priority to an unsigned key with the same ordering
+static unsigned int RND_timingWheelKey(int priority)
+{
+    return (unsigned int)priority ^ ~(UINT_MAX >> 1);
+}
+
+// Extract the slot number of a key on a given level
+static unsigned int RND_timingWheelByte(unsigned int key, size_t level)
+{
+    return (key >> (level * RND_TIMING_WHEEL_BITS)) & (RND_TIMING_WHEEL_SLOTS - 1);
+}
+
+// Find the first non-empty slot on a level, starting from slot "from"
+static int RND_timingWheelFind(const RND_TimingWheel *wheel, size_t level, unsigned int from)
+{
+    size_t base = level * RND_TIMING_WHEEL_SLOTS;
+    for (unsigned int i = from; i < RND_TIMING_WHEEL_SLOTS; i = (i | 63) + 1) {
+        uint64_t word = wheel->occupied[(base + i) / 64] >> ((base + i) % 64);
+        if (word) {
+            return i + __builtin_ctzll(word);
+        }
+    }
+    return -1;
+}
+
+// Append a timer to the slot matching its priority relative to the current time
+static void RND_timingWheelPlace(RND_TimingWheel *wheel, RND_TimingWheelTimer *timer)
+{
+    unsigned int key  = RND_timingWheelKey(timer->priority > wheel->now? timer->priority : wheel->now);
+    unsigned int diff = key ^ RND_timingWheelKey(wheel->now);
+    size_t level = diff? (sizeof(unsigned int) * CHAR_BIT - 1 - __builtin_clz(diff)) / RND_TIMING_WHEEL_BITS : 0;
+    unsigned int slot = level * RND_TIMING_WHEEL_SLOTS + RND_timingWheelByte(key, level);
+    timer->slot = slot;
+    timer->next = NULL;
+    timer->prev = wheel->tail[slot];
+    if (wheel->tail[slot]) {
+        wheel->tail[slot]->next = timer;
+    } else {
+        wheel->head[slot] = timer;
+    }
+    wheel->tail[slot] = timer;
+    wheel->occupied[slot / 64] |= (uint64_t)1 << (slot % 64);
+}
+
+static void RND_timingWheelUnlink(RND_TimingWheel *wheel, RND_TimingWheelTimer *timer)
+{
+    unsigned int slot = timer->slot;
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        wheel->head[slot] = timer->next;
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    } else {
+        wheel->tail[slot] = timer->prev;
+    }
+    if (!wheel->head[slot]) {
+        wheel->occupied[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+    }
+    timer->next = wheel->free;
+    wheel->free = timer;
+}
+
+/* Return the front timer, first cascading the nearest non-empty slot
+ * of a higher level down if the lowest level has nothing left.
+ */
+static RND_TimingWheelTimer *RND_timingWheelFront(RND_TimingWheel *wheel)
+{
+    if (!wheel->size) {
+        return NULL;
+    }
+    for (;;) {
+        unsigned int now = RND_timingWheelKey(wheel->now);
+        int slot = RND_timingWheelFind(wheel, 0, RND_timingWheelByte(now, 0));
+        if (slot >= 0) {
+            RND_TimingWheelTimer *front = wheel->head[slot];
+            if (front->priority > wheel->now) {
+                wheel->now = front->priority;
+            }
+            return front;
+        }
+        size_t level = 1;
+        for (; level < RND_TIMING_WHEEL_LEVELS; level++) {
+            unsigned int from = RND_timingWheelByte(now, level) + 1;
+            if (from < RND_TIMING_WHEEL_SLOTS && (slot = RND_timingWheelFind(wheel, level, from)) >= 0) {
+                break;
+            }
+        }
+        if (level == RND_TIMING_WHEEL_LEVELS) {
+            RND_ERROR("the wheel holds %lu timers but none could be found", wheel->size);
+            return NULL;
+        }
+        slot += level * RND_TIMING_WHEEL_SLOTS;
+        RND_TimingWheelTimer *timer = wheel->head[slot];
+        int min = timer->priority;
+        for (; timer; timer = timer->next) {
+            if (timer->priority < min) {
+                min = timer->priority;
+            }
+        }
+        wheel->now = min;
+        timer = wheel->head[slot];
+        wheel->head[slot] = wheel->tail[slot] = NULL;
+        wheel->occupied[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+        while (timer) {
+            RND_TimingWheelTimer *next = timer->next;
+            RND_timingWheelPlace(wheel, timer);
+            timer = next;
+        }
+    }
+}
+
+RND_TimingWheel *RND_timingWheelCreate()
+{
+    RND_TimingWheel *wheel;
+    if (!(wheel = (RND_TimingWheel*)malloc(sizeof(RND_TimingWheel)))) {
+        RND_ERROR("malloc");
+        return NULL;
+    }
+    for (size_t i = 0; i < RND_TIMING_WHEEL_LEVELS * RND_TIMING_WHEEL_SLOTS; i++) {
+        wheel->head[i] = wheel->tail[i] = NULL;
+    }
+    for (size_t i = 0; i < RND_TIMING_WHEEL_LEVELS * RND_TIMING_WHEEL_SLOTS / 64; i++) {
+        wheel->occupied[i] = 0;
+    }
+    wheel->now = INT_MIN;
+    wheel->size = 0;
+    wheel->free = NULL;
+    return wheel;
+}
+
+int RND_timingWheelPush(RND_TimingWheel *wheel, const void *data, int priority)
+{
+    return RND_timingWheelPushHandle(wheel, data, priority, NULL);
+}
+
+int RND_timingWheelPushHandle(RND_TimingWheel *wheel, const void *data, int priority, RND_TimingWheelTimer **timer)
+{
+    if (!wheel) {
+        RND_ERROR("the wheel does not exist");
+        return 2;
+    }
+    RND_TimingWheelTimer *new;
+    if (wheel->free) {
+        new = wheel->free;
+        wheel->free = new->next;
+    } else if (!(new = (RND_TimingWheelTimer*)malloc(sizeof(RND_TimingWheelTimer)))) {
+        RND_ERROR("malloc");
+        return 1;
+    }
+    new->data = (void*)data;
+    new->priority = priority;
+    RND_timingWheelPlace(wheel, new);
+    wheel->size++;
+    if (timer) {
+        *timer = new;
+    }
+    return 0;
+}
+
+void *RND_timingWheelPeek(RND_TimingWheel *wheel)
+{
+    if (!wheel) {
+        return NULL;
+    }
+    RND_TimingWheelTimer *front = RND_timingWheelFront(wheel);
+    return front? front->data : NULL;
+}
+
+int RND_timingWheelPop(RND_TimingWheel *wheel, int (*dtor)(const void*))
+{
+    if (!wheel) {
+        RND_ERROR("the wheel does not exist");
+        return 1;
+    }
+    RND_TimingWheelTimer *front;
+    if (!(front = RND_timingWheelFront(wheel))) {
+        RND_WARN("the wheel is already empty");
+        return 1;
+    }
+    int error;
+    if (dtor && (error = dtor(front->data))) {
+        RND_ERROR("dtor returned %d for data %p", error, front->data);
+        return 2;
+    }
+    RND_timingWheelUnlink(wheel, front);
+    wheel->size--;
+    return 0;
+}
+
+int RND_timingWheelCancel(RND_TimingWheel *wheel, RND_TimingWheelTimer *timer, int (*dtor)(const void*))
+{
+    if (!wheel || !timer) {
+        RND_ERROR("the wheel or the timer does not exist");
+        return 1;
+    }
+    int error;
+    if (dtor && (error = dtor(timer->data))) {
+        RND_ERROR("dtor returned %d for data %p", error, timer->data);
+        return 2;
+    }
+    RND_timingWheelUnlink(wheel, timer);
+    wheel->size--;
+    return 0;
+}
+
+int RND_timingWheelClear(RND_TimingWheel *wheel, int (*dtor)(const void*))
+{
+    if (!wheel) {
+        RND_ERROR("the wheel does not exist");
+        return 2;
+    }
+    for (size_t level = 0; level < RND_TIMING_WHEEL_LEVELS && wheel->size; level++) {
+        int slot;
+        while ((slot = RND_timingWheelFind(wheel, level, 0)) >= 0) {
+            RND_TimingWheelTimer *timer = wheel->head[level * RND_TIMING_WHEEL_SLOTS + slot];
+            int error;
+            if (dtor && (error = dtor(timer->data))) {
+                RND_ERROR("dtor returned %d for data %p", error, timer->data);
+                return 1;
+            }
+            RND_timingWheelUnlink(wheel, timer);
+            wheel->size--;
+        }
+    }
+    return 0;
+}
+
+int RND_timingWheelDestroy(RND_TimingWheel *wheel, int (*dtor)(const void*))
+{
+    if (!wheel) {
+        RND_ERROR("the wheel does not exist");
+        return 2;
+    }
+    int error;
+    if ((error = RND_timingWheelClear(wheel, dtor))) {
+        RND_ERROR("RND_timingWheelClear returned error %d", error);
+        return error;
+    }
+    while (wheel->free) {
+        RND_TimingWheelTimer *next = wheel->free->next;
+        free(wheel->free);
+        wheel->free = next;
+    }
+    free(wheel);
+    return 0;
+}
+
+size_t RND_timingWheelSize(const RND_TimingWheel *wheel)
+{
+    if (!wheel) {
+        RND_ERROR("the wheel does not exist");
+        return 0;
+    }
+    return wheel->size;
+}
+
+int RND_timingWheelDtorFree(const void *data)
+{
+    free((void*)data);
+    return 0;
+}
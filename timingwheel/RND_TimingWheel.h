@@ -0,0 +1,234 @@
+/** @file
+ * The header file of the RND_TimingWheel library.
+ *
+ * A timing wheel is a priority queue specialized for timers,
+ * i.e. elements keyed by integer deadlines. It has the same
+ * push/peek/pop surface as @ref RND_PriorityQueue, but inserting
+ * and cancelling a timer take constant time, and popping is
+ * amortized constant time no matter how many timers are pending.
+ *
+ * @example timingwheel/example.c
+ * Here's an example usage of the RND_TimingWheel library.
+ */
+
+#ifndef RND_TIMING_WHEEL_H
+#define RND_TIMING_WHEEL_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+
+/********************************************************
+ *                      CONSTANTS                       *
+ ********************************************************/
+
+/// The number of priority bits resolved by a single wheel level.
+#define RND_TIMING_WHEEL_BITS 8
+
+/// The number of slots on a single wheel level.
+#define RND_TIMING_WHEEL_SLOTS (1 << RND_TIMING_WHEEL_BITS)
+
+/// The number of wheel levels needed to cover the whole @c int range.
+#define RND_TIMING_WHEEL_LEVELS ((sizeof(int) * CHAR_BIT + RND_TIMING_WHEEL_BITS - 1) / RND_TIMING_WHEEL_BITS)
+
+/********************************************************
+ *                     STRUCTURES                       *
+ ********************************************************/
+
+/// @cond
+typedef struct RND_TimingWheel RND_TimingWheel;
+typedef struct RND_TimingWheelTimer RND_TimingWheelTimer;
+/// @endcond
+
+/** A single timer stored in a @ref RND_TimingWheel.
+ *
+ * A pointer to this struct can be obtained with @ref
+ * RND_timingWheelPushHandle and later passed to @ref
+ * RND_timingWheelCancel. It stays valid until the timer
+ * is popped, cancelled or cleared, after which its memory
+ * is reused for other timers.
+ */
+struct RND_TimingWheelTimer
+{
+    /// The previous timer in the same slot.
+    RND_TimingWheelTimer *prev;
+    /// The next timer in the same slot.
+    RND_TimingWheelTimer *next;
+    /// A pointer to the stored data.
+    void *data;
+    /// The deadline of the timer.
+    int priority;
+    /// The index of the slot holding the timer (level * slots + slot).
+    unsigned int slot;
+};
+
+/** A hierarchical timing wheel for integer priorities.
+ *
+ * The wheel has @ref RND_TIMING_WHEEL_LEVELS levels of @ref
+ * RND_TIMING_WHEEL_SLOTS slots each. A timer is placed on the
+ * level of the highest byte in which its priority differs from
+ * the wheel's current time (@ref now), in the slot given by that
+ * byte of its priority. Only the lowest level ever has to be
+ * searched for the front timer; when it runs empty, the first
+ * non-empty slot of the next level is cascaded down. Every timer
+ * moves down at most @ref RND_TIMING_WHEEL_LEVELS times, which
+ * makes popping amortized O(1). Bitmaps of occupied slots make
+ * finding the next non-empty slot a few word scans.
+ *
+ * Timers with equal priorities are popped in insertion order.
+ */
+struct RND_TimingWheel
+{
+    /// The first timer in each slot.
+    RND_TimingWheelTimer *head[RND_TIMING_WHEEL_LEVELS * RND_TIMING_WHEEL_SLOTS];
+    /// The last timer in each slot.
+    RND_TimingWheelTimer *tail[RND_TIMING_WHEEL_LEVELS * RND_TIMING_WHEEL_SLOTS];
+    /// One bit per slot, set if the slot is not empty.
+    uint64_t occupied[RND_TIMING_WHEEL_LEVELS * RND_TIMING_WHEEL_SLOTS / 64];
+    /** The current time of the wheel.
+     *
+     * This is the priority of the last timer that was popped
+     * or peeked. Timers pushed with an earlier deadline are
+     * considered overdue and are scheduled at @ref now.
+     */
+    int now;
+    /// The number of timers in the wheel.
+    size_t size;
+    /// Timers that were removed, kept for reuse.
+    RND_TimingWheelTimer *free;
+};
+
+/********************************************************
+ *                      FUNCTIONS                       *
+ ********************************************************/
+
+/** Allocates a new empty timing wheel and returns its pointer.
+ *
+ * The current time of the new wheel is @c INT_MIN, so any
+ * priority can be pushed until the first peek or pop.
+ *
+ * @returns
+ * - the new wheel's address - success
+ * - @c NULL - insufficient memory
+ */
+RND_TimingWheel *RND_timingWheelCreate();
+
+/** Inserts an element into a timing wheel in O(1).
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @param[in] data The address of the data to be stored.
+ * @param[in] priority The deadline for the new element.
+ * Elements with lower priority precede elements with
+ * higher priority. A priority lower than @ref
+ * RND_TimingWheel::now is treated as equal to it.
+ * @returns
+ * - 0 - success
+ * - 1 - insufficient memory
+ * - 2 - @p wheel is @c NULL
+ */
+int RND_timingWheelPush(RND_TimingWheel *wheel, const void *data, int priority);
+
+/** Inserts an element into a timing wheel and returns its timer.
+ *
+ * Works just like @ref RND_timingWheelPush, but additionally
+ * stores the new timer's address in @p timer, so that it
+ * can be cancelled later with @ref RND_timingWheelCancel.
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @param[in] data The address of the data to be stored.
+ * @param[in] priority The deadline for the new element.
+ * @param[out] timer Where to store the new timer's address.
+ * @returns
+ * - 0 - success
+ * - 1 - insufficient memory
+ * - 2 - @p wheel is @c NULL
+ */
+int RND_timingWheelPushHandle(RND_TimingWheel *wheel, const void *data, int priority, RND_TimingWheelTimer **timer);
+
+/** Returns a pointer to the front element of a timing wheel.
+ *
+ * Finding the front element may cascade timers down to a lower
+ * level and moves @ref RND_TimingWheel::now to the front
+ * element's priority, which is why @p wheel is not @c const.
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @returns
+ * - the front element's @ref RND_TimingWheelTimer::data - success
+ * - @c NULL - the wheel is empty or @p wheel is @c NULL
+ */
+void *RND_timingWheelPeek(RND_TimingWheel *wheel);
+
+/** Removes the front element of a timing wheel.
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @param[in] dtor A pointer to a function which intakes
+ * @ref RND_TimingWheelTimer::data and frees it, returning 0 for
+ * success and anything else for failure @b OR @c NULL
+ * if the data doesn't need to be freed.
+ * @returns
+ * - 0 - success
+ * - 1 - the wheel is empty or @p wheel is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_timingWheelPop(RND_TimingWheel *wheel, int (*dtor)(const void*));
+
+/** Removes a pending timer from a timing wheel in O(1).
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @param[in] timer A timer obtained from @ref
+ * RND_timingWheelPushHandle, which must still be in @p wheel.
+ * @param[in] dtor Same as in @ref RND_timingWheelPop.
+ * @returns
+ * - 0 - success
+ * - 1 - @p wheel or @p timer is @c NULL
+ * - 2 - @p dtor returned non-0 (error)
+ */
+int RND_timingWheelCancel(RND_TimingWheel *wheel, RND_TimingWheelTimer *timer, int (*dtor)(const void*));
+
+/** Removes all elements from a timing wheel.
+ *
+ * The memory of removed timers is kept for reuse and
+ * @ref RND_TimingWheel::now is left unchanged.
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @param[in] dtor Same as in @ref RND_timingWheelPop.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0
+ * - 2 - @p wheel is @c NULL
+ */
+int RND_timingWheelClear(RND_TimingWheel *wheel, int (*dtor)(const void*));
+
+/** Frees all memory associated with a timing wheel.
+ *
+ * @param[inout] wheel A pointer to the wheel.
+ * @param[in] dtor This argument is passed directly
+ * to @ref RND_timingWheelClear.
+ * @returns
+ * - 0 - success
+ * - 1 - some @p dtor returned non-0 (the wheel is not freed)
+ * - 2 - @p wheel is @c NULL
+ */
+int RND_timingWheelDestroy(RND_TimingWheel *wheel, int (*dtor)(const void*));
+
+/** Returns the number of elements in a timing wheel.
+ *
+ * @param[in] wheel A pointer to the wheel.
+ * @returns
+ * - the size of the wheel - success
+ * - 0 - if @p wheel is @c NULL (or wheel is empty)
+ */
+size_t RND_timingWheelSize(const RND_TimingWheel *wheel);
+
+/** A basic dtor function to be used with other functions.
+ *
+ * This function simply calls @c free() on @p data, so that
+ * you don't have to write it yourself when removing elements
+ * with @ref RND_timingWheelPop, @ref RND_timingWheelCancel,
+ * @ref RND_timingWheelClear or @ref RND_timingWheelDestroy.
+ * @param[in] data A pointer to data to be freed.
+ * @returns 0
+ */
+int RND_timingWheelDtorFree(const void *data);
+
+#endif /* RND_TIMING_WHEEL_H */
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <RND_TimingWheel.h>
+#include <RND_PriorityQueue.h>
+#include <RND_Utils.h>
+
+#define PENDING 20000
+#define STEPS   200000
+#define CANCELS 5000
+#define SPAN    100000
+
+/* Simulates a timer workload: PENDING timers are scheduled, then for
+ * STEPS steps the earliest one expires and a new one is scheduled
+ * up to SPAN ticks into the future. Finally CANCELS random pending
+ * timers are cancelled. The same sequence is run on the sorted-array
+ * RND_PriorityQueue and on the timing wheel, checking that both
+ * expire the timers in the same order.
+ */
+
+int deadlines[PENDING + STEPS];
+int victims[CANCELS];
+int expired[STEPS];
+
+// Find a pending element of a sorted queue and remove it, as RND_Game does
+void sortedCancel(RND_PriorityQueue *queue, const int *deadline)
+{
+    RND_PriorityQueuePair *elem = queue->head;
+    for (size_t i = 0; i < queue->size; i++) {
+        if (elem->value == deadline) {
+            RND_priorityQueueRemove(queue, i, NULL);
+            return;
+        }
+        elem = (elem == queue->data + queue->capacity - 1)? queue->data : elem + 1;
+    }
+}
+
+void runSorted()
+{
+    RND_PriorityQueue *queue = RND_priorityQueueCreate(PENDING);
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < PENDING; i++) {
+        RND_priorityQueuePush(queue, deadlines + i, deadlines[i]);
+    }
+    double mid1 = RND_getWallTime_usec();
+    for (int i = 0; i < STEPS; i++) {
+        int *deadline = RND_priorityQueuePeek(queue);
+        expired[i] = deadline - deadlines;
+        RND_priorityQueuePop(queue, NULL);
+        deadlines[PENDING + i] = *deadline + 1 + rand() % SPAN;
+        RND_priorityQueuePush(queue, deadlines + PENDING + i, deadlines[PENDING + i]);
+    }
+    double mid2 = RND_getWallTime_usec();
+    for (int i = 0; i < CANCELS; i++) {
+        sortedCancel(queue, deadlines + victims[i]);
+    }
+    double end = RND_getWallTime_usec();
+    printf("%-8s | %10.2f | %10.2f | %10.2f\n", "sorted", (mid1 - start) / 1000, (mid2 - mid1) / 1000, (end - mid2) / 1000);
+    RND_priorityQueueDestroy(queue, NULL);
+}
+
+void runWheel()
+{
+    static RND_TimingWheelTimer *timers[PENDING + STEPS];
+    RND_TimingWheel *wheel = RND_timingWheelCreate();
+    double start = RND_getWallTime_usec();
+    for (int i = 0; i < PENDING; i++) {
+        RND_timingWheelPushHandle(wheel, deadlines + i, deadlines[i], timers + i);
+    }
+    double mid1 = RND_getWallTime_usec();
+    for (int i = 0; i < STEPS; i++) {
+        int *deadline = RND_timingWheelPeek(wheel);
+        if (deadline - deadlines != expired[i]) {
+            printf("wheel: timers expired out of order\n");
+            exit(EXIT_FAILURE);
+        }
+        RND_timingWheelPop(wheel, NULL);
+        timers[deadline - deadlines] = NULL;
+        RND_timingWheelPushHandle(wheel, deadlines + PENDING + i, deadlines[PENDING + i], timers + PENDING + i);
+    }
+    double mid2 = RND_getWallTime_usec();
+    for (int i = 0; i < CANCELS; i++) {
+        if (timers[victims[i]]) {
+            RND_timingWheelCancel(wheel, timers[victims[i]], NULL);
+            timers[victims[i]] = NULL;
+        }
+    }
+    double end = RND_getWallTime_usec();
+    printf("%-8s | %10.2f | %10.2f | %10.2f\n", "wheel", (mid1 - start) / 1000, (mid2 - mid1) / 1000, (end - mid2) / 1000);
+    RND_timingWheelDestroy(wheel, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    srand(1);
+    for (int i = 0; i < PENDING; i++) {
+        deadlines[i] = rand() % SPAN;
+    }
+    // The sorted run fills in the rescheduled deadlines for the wheel run
+    for (int i = 0; i < CANCELS; i++) {
+        victims[i] = PENDING + STEPS - 1 - i * 3;
+    }
+    printf("%d pending timers, %d expirations, %d cancellations\n", PENDING, STEPS, CANCELS);
+    printf("QUEUE    |  PUSH (ms) |  TICK (ms) | CANCEL (ms)\n");
+    runSorted();
+    runWheel();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <RND_TimingWheel.h>
+
+int main(int argc, char **argv)
+{
+    static const char *names[] = { "save", "blink", "respawn", "autosave", "fade" };
+    RND_TimingWheel *timers = RND_timingWheelCreate();
+    RND_TimingWheelTimer *autosave;
+
+    // Schedule a few events at absolute deadlines (e.g. in milliseconds)
+    RND_timingWheelPush(timers, names[0], 5000);
+    RND_timingWheelPush(timers, names[1], 250);
+    RND_timingWheelPush(timers, names[2], 3000);
+    RND_timingWheelPushHandle(timers, names[3], 60000, &autosave);
+    RND_timingWheelPush(timers, names[4], 250);
+
+    // The autosave is no longer needed
+    RND_timingWheelCancel(timers, autosave, NULL);
+
+    while (RND_timingWheelSize(timers)) {
+        const char *name = RND_timingWheelPeek(timers);
+        printf("t=%5d: %s\n", timers->now, name);
+        RND_timingWheelPop(timers, NULL);
+        // Timers can be scheduled from within other timers
+        if (name == names[1]) {
+            RND_timingWheelPush(timers, names[1], timers->now + 1000);
+        }
+        if (timers->now > 4000) {
+            break;
+        }
+    }
+    RND_timingWheelDestroy(timers, NULL);
+
+    return EXIT_SUCCESS;
+}